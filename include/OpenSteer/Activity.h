@@ -0,0 +1,108 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// Activity: sleep/wake state for agents which have come to rest
+//
+// An agent whose applied steering force and speed both stay below the
+// thresholds for a given number of consecutive steps is put to sleep, and
+// its owner skips updating it until it is woken: explicitly (wake) or by
+// a proximity event, such as a point of interest coming within the wake
+// radius.  Waking resets the quiet step count.
+//
+// Usage:
+//         if (agent.activity.isAsleep ()) continue;
+//         ... step agent, with applied steering force "steer" ...
+//         agent.activity.observe (steer.length (), agent.speed (), limits);
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#ifndef OPENSTEER_ACTIVITY_H
+#define OPENSTEER_ACTIVITY_H
+
+
+namespace OpenSteer {
+
+    class Activity
+    {
+    public:
+
+        struct Thresholds
+        {
+            Thresholds (void)
+                : force (0.01f), speed (0.01f), frames (0), wakeRadius (10) {}
+
+            float force;        // steering force below this is "quiet"
+            float speed;        // speed below this is "quiet"
+            int frames;         // quiet steps before sleeping, 0: never
+            float wakeRadius;   // proximity events within this wake it
+        };
+
+        Activity (void) : quietSteps (0), asleep (false) {}
+
+        // record one step's applied steering force magnitude and speed,
+        // returns true if the agent has just fallen asleep
+        bool observe (const float force,
+                      const float speed,
+                      const Thresholds& t)
+        {
+            const bool quiet = (force < t.force) && (speed < t.speed);
+            quietSteps = quiet ? quietSteps + 1 : 0;
+            asleep = (t.frames > 0) && (quietSteps >= t.frames);
+            return asleep;
+        }
+
+        bool isAsleep (void) const {return asleep;}
+        int getQuietSteps (void) const {return quietSteps;}
+
+        // restore a state saved with getQuietSteps and isAsleep
+        void restore (const int quiet, const bool sleeping)
+        {
+            quietSteps = quiet;
+            asleep = sleeping;
+        }
+
+        void wake (void)
+        {
+            quietSteps = 0;
+            asleep = false;
+        }
+
+    private:
+
+        int quietSteps;
+        bool asleep;
+    };
+
+} // namespace OpenSteer
+
+
+// ----------------------------------------------------------------------------
+#endif // OPENSTEER_ACTIVITY_H
@@ -50,6 +50,7 @@
 #endif // NOT_OPENSTEERDEMO
 #include "OpenSteer/Vec3.h"
 #include "OpenSteer/Color.h"
+#include "OpenSteer/TrailPool.h"
 
 // ----------------------------------------------------------------------------
 
@@ -90,10 +91,12 @@ namespace OpenSteer {
         void drawTrail  (const Color& trailColor, const Color& tickColor);
 
         // set trail parameters: the amount of time it represents and the
-        // number of samples along its length.  re-allocates internal buffers.
+        // number of samples along its length.  Storage for the trail is not
+        // allocated until the first recordTrailVertex.
         void setTrailParameters (const float duration, const int vertexCount);
 
         // forget trail history: used to prevent long streaks due to teleportation
+        // (returns the trail's storage to the shared TrailPool)
         void clearTrailHistory (void);
 
         // ------------------------------------------------------------------------
@@ -212,6 +215,74 @@ namespace OpenSteer {
         Vec3 curPosition;           // last reported position of vehicle
         Vec3* trailVertices;        // array (ring) of recent points along trail
         char* trailFlags;           // array (ring) of flag bits for trail points
+                                    // (both NULL until first recorded vertex,
+                                    // then one block from TrailPool)
+        void resetTrailState (void);
+    };
+
+
+    // ------------------------------------------------------------------------
+    // NullAnnotationMixin: same interface as AnnotationMixin, but every
+    // function is an inline no-op and it has no state.  SimpleVehicle uses
+    // it in place of AnnotationMixin when OPENSTEER_NO_ANNOTATION is defined
+    // (production builds), so annotation costs neither time nor memory.
+    // (parameter names commented out to prevent compiler warning from "-W")
+
+    template <class Super>
+    class NullAnnotationMixin : public Super
+    {
+    public:
+
+        // trails / streamers
+        void recordTrailVertex (const float /*currentTime*/,
+                                const Vec3& /*position*/) {}
+        void drawTrail (void) {}
+        void drawTrail (const Color& /*trailColor*/,
+                        const Color& /*tickColor*/) {}
+        void setTrailParameters (const float /*duration*/,
+                                 const int /*vertexCount*/) {}
+        void clearTrailHistory (void) {}
+
+        // lines, circles and disks
+        void annotationLine (const Vec3& /*startPoint*/,
+                             const Vec3& /*endPoint*/,
+                             const Color& /*color*/) const {}
+        void annotationXZCircle (const float /*radius*/,
+                                 const Vec3& /*center*/,
+                                 const Color& /*color*/,
+                                 const int /*segments*/) const {}
+        void annotationXZDisk (const float /*radius*/,
+                               const Vec3& /*center*/,
+                               const Color& /*color*/,
+                               const int /*segments*/) const {}
+        void annotation3dCircle (const float /*radius*/,
+                                 const Vec3& /*center*/,
+                                 const Vec3& /*axis*/,
+                                 const Color& /*color*/,
+                                 const int /*segments*/) const {}
+        void annotation3dDisk (const float /*radius*/,
+                               const Vec3& /*center*/,
+                               const Vec3& /*axis*/,
+                               const Color& /*color*/,
+                               const int /*segments*/) const {}
+        void annotationXZCircleOrDisk (const float /*radius*/,
+                                       const Vec3& /*center*/,
+                                       const Color& /*color*/,
+                                       const int /*segments*/,
+                                       const bool /*filled*/) const {}
+        void annotation3dCircleOrDisk (const float /*radius*/,
+                                       const Vec3& /*center*/,
+                                       const Vec3& /*axis*/,
+                                       const Color& /*color*/,
+                                       const int /*segments*/,
+                                       const bool /*filled*/) const {}
+        void annotationCircleOrDisk (const float /*radius*/,
+                                     const Vec3& /*axis*/,
+                                     const Vec3& /*center*/,
+                                     const Color& /*color*/,
+                                     const int /*segments*/,
+                                     const bool /*filled*/,
+                                     const bool /*in3d*/) const {}
     };
 
 } // namespace OpenSteer
@@ -228,11 +299,8 @@ OpenSteer::AnnotationMixin<Super>::AnnotationMixin (void)
     trailVertices = NULL;
     trailFlags = NULL;
 
-    // xxx I wonder if it makes more sense to NOT do this here, see if the
-    // xxx vehicle class calls it to set custom parameters, and if not, set
-    // xxx these default parameters on first call to a "trail" function.  The
-    // xxx issue is whether it is a problem to allocate default-sized arrays
-    // xxx then to free them and allocate new ones
+    // only records parameters: most vehicles never draw a trail, so storage
+    // is taken from TrailPool on the first call to recordTrailVertex
     setTrailParameters (5, 100);  // 5 seconds with 100 points along the trail
 }
 
@@ -240,14 +308,13 @@ OpenSteer::AnnotationMixin<Super>::AnnotationMixin (void)
 template<class Super>
 OpenSteer::AnnotationMixin<Super>::~AnnotationMixin (void)
 {
-    delete[] trailVertices;
-    delete[] trailFlags;
+    TrailPool::release (trailVertexCount, trailVertices, trailFlags);
 }
 
 
 // ----------------------------------------------------------------------------
 // set trail parameters: the amount of time it represents and the number of
-// samples along its length.  re-allocates internal buffers.
+// samples along its length.
 
 
 template<class Super>
@@ -255,26 +322,26 @@ void
 OpenSteer::AnnotationMixin<Super>::setTrailParameters (const float duration, 
                                                        const int vertexCount)
 {
+    // give back storage sized for the old vertex count, if any
+    TrailPool::release (trailVertexCount, trailVertices, trailFlags);
+
     // record new parameters
     trailDuration = duration;
     trailVertexCount = vertexCount;
+    trailSampleInterval = trailDuration / trailVertexCount;
 
     // reset other internal trail state
+    resetTrailState ();
+}
+
+
+template<class Super>
+void 
+OpenSteer::AnnotationMixin<Super>::resetTrailState (void)
+{
     trailIndex = 0;
     trailLastSampleTime = 0;
-    trailSampleInterval = trailDuration / trailVertexCount;
     trailDottedPhase = 1;
-
-    // prepare trailVertices array: free old one if needed, allocate new one
-    delete[] trailVertices;
-    trailVertices = new Vec3[trailVertexCount];
-
-    // prepare trailFlags array: free old one if needed, allocate new one
-    delete[] trailFlags;
-    trailFlags = new char[trailVertexCount];
-
-    // initializing all flags to zero means "do not draw this segment"
-    for (int i = 0; i < trailVertexCount; i++) trailFlags[i] = 0;
 }
 
 
@@ -289,8 +356,10 @@ template<class Super>
 void 
 OpenSteer::AnnotationMixin<Super>::clearTrailHistory (void)
 {
-    // brute force implementation, reset everything
-    setTrailParameters (trailDuration, trailVertexCount);
+    // return storage to the pool, it is re-acquired (with all flags zero)
+    // if and when another vertex is recorded
+    TrailPool::release (trailVertexCount, trailVertices, trailFlags);
+    resetTrailState ();
 }
 
 
@@ -306,6 +375,14 @@ OpenSteer::AnnotationMixin<Super>::recordTrailVertex (const float currentTime,
     const float timeSinceLastTrailSample = currentTime - trailLastSampleTime;
     if (timeSinceLastTrailSample > trailSampleInterval)
     {
+        // first vertex since construction or clearTrailHistory: take
+        // storage from the pool.  All flags zero means "do not draw".
+        if (trailVertices == NULL)
+        {
+            TrailPool::acquire (trailVertexCount, trailVertices, trailFlags);
+            for (int i = 0; i < trailVertexCount; i++) trailFlags[i] = 0;
+        }
+
         trailIndex = (trailIndex + 1) % trailVertexCount;
         trailVertices [trailIndex] = position;
         trailDottedPhase = (trailDottedPhase + 1) % 2;
@@ -327,7 +404,7 @@ void
 OpenSteer::AnnotationMixin<Super>::drawTrail (const Color& trailColor,
                                               const Color& tickColor)
 {
-    if (enableAnnotation)
+    if (enableAnnotation && (trailVertices != NULL))
     {
         int index = trailIndex;
         for (int j = 0; j < trailVertexCount; j++)
@@ -0,0 +1,142 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// Arena: typed slab for objects that share one lifetime
+//
+// Objects are constructed in place, in creation order, inside large blocks
+// of storage; they are never freed individually.  clear () destroys them
+// all (in reverse creation order) and releases the blocks in one go.  With
+// reserve () sized to the expected population, a whole group of objects is
+// a single allocation laid out contiguously in memory.  When a block fills
+// up a new one, twice as large, is started, so created objects never move.
+//
+// Usage:
+//         Arena<MpPursuer> pursuers;
+//         pursuers.reserve (n);
+//         for (...) group.push_back (pursuers.create (wanderer, population));
+//         ...
+//         pursuers.clear ();
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#ifndef OPENSTEER_ARENA_H
+#define OPENSTEER_ARENA_H
+
+
+#include "OpenSteer/StandardTypes.h"
+
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+
+namespace OpenSteer {
+
+    template <class T>
+    class Arena
+    {
+    public:
+
+        Arena (void) : _size (0) {}
+        ~Arena (void) {clear ();}
+
+        // make room for at least n objects in total without a further
+        // allocation (only has an effect before the first create)
+        void reserve (const size_t n)
+        {
+            if (blocks.empty () && n > 0) addBlock (n);
+        }
+
+        // construct a new object in place, passing args to its constructor
+        template <class... Args>
+        T* create (Args&&... args)
+        {
+            if (blocks.empty () || blocks.back().used == blocks.back().capacity)
+                addBlock (blocks.empty () ? 64 : 2 * blocks.back().capacity);
+            Block& b = blocks.back ();
+            T* object = new (b.data + b.used) T (std::forward<Args> (args)...);
+            b.used++;
+            _size++;
+            return object;
+        }
+
+        // destroy every object and release all storage
+        void clear (void)
+        {
+            std::allocator<T> allocator;
+            while (! blocks.empty ())
+            {
+                Block& b = blocks.back ();
+                while (b.used > 0) b.data[--b.used].~T ();
+                allocator.deallocate (b.data, b.capacity);
+                blocks.pop_back ();
+            }
+            _size = 0;
+        }
+
+        // number of live objects
+        size_t size (void) const {return _size;}
+
+        // number of blocks currently allocated
+        size_t blockCount (void) const {return blocks.size ();}
+
+    private:
+
+        struct Block
+        {
+            T* data;
+            size_t used;
+            size_t capacity;
+        };
+
+        void addBlock (const size_t capacity)
+        {
+            Block b;
+            b.data = std::allocator<T> ().allocate (capacity);
+            b.used = 0;
+            b.capacity = capacity;
+            blocks.push_back (b);
+        }
+
+        std::vector<Block> blocks;
+        size_t _size;
+
+        // not copyable: objects are referred to by address
+        Arena (const Arena&);
+        Arena& operator= (const Arena&);
+    };
+
+} // namespace OpenSteer
+
+
+// ----------------------------------------------------------------------------
+#endif // OPENSTEER_ARENA_H
@@ -0,0 +1,112 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// BatchRunner: runs many independent tasks (e.g. whole worlds) in parallel
+//
+// The tasks run on a TaskScheduler, one scheduler task per batch task: the
+// calling thread queues them all and works through its queue from the
+// front while the workers steal from the back, so uneven task costs still
+// balance out.  Each task runs start to finish on one thread; a task which
+// builds and steps its own world therefore keeps that world on one thread
+// (and, with pinning, one CPU) for its whole lifetime, which is good for
+// cache locality.  Threads can be pinned to CPUs (Linux only).  The
+// threads persist across calls to run.
+//
+// Usage:
+//         BatchRunner runner (threads);
+//         const BatchRunner::Report r = runner.run (worlds, [&] (size_t i)
+//         {
+//             MpWorld w; ... return w.agentSteps ();
+//         });
+//         BatchRunner::printReport (std::cout, r, "agent steps");
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#ifndef OPENSTEER_BATCHRUNNER_H
+#define OPENSTEER_BATCHRUNNER_H
+
+
+#include "OpenSteer/StandardTypes.h"
+#include "OpenSteer/TaskScheduler.h"
+
+#include <functional>
+#include <iosfwd>
+#include <stdint.h>
+#include <vector>
+
+
+namespace OpenSteer {
+
+    class BatchRunner
+    {
+    public:
+
+        struct Report
+        {
+            size_t tasks;                        // tasks run
+            int threads;                         // worker threads used
+            double seconds;                      // wall clock time
+            uint64_t work;                       // sum of task results
+            size_t steals;                       // tasks run by a thread
+                                                 // other than the caller
+            std::vector<size_t> tasksPerThread;
+        };
+
+        // threadCount counts the calling thread, 0 uses one thread per
+        // hardware thread
+        BatchRunner (const int threadCount = 0, const bool pinThreads = true);
+
+        // run task (i) for every i in [0, count), returns when all are
+        // done.  A task returns the amount of work it did (in any unit,
+        // say agent steps), which is summed into the report.  An exception
+        // thrown by a task is rethrown here once every task is done.
+        Report run (const size_t count,
+                    const std::function<uint64_t (size_t)>& task);
+
+        // tasks and work per second, and the per thread distribution
+        static void printReport (std::ostream& o,
+                                 const Report& r,
+                                 const char* workUnit);
+
+    private:
+
+        TaskScheduler scheduler;
+
+        // not copyable
+        BatchRunner (const BatchRunner&);
+        BatchRunner& operator= (const BatchRunner&);
+    };
+
+} // namespace OpenSteer
+
+
+// ----------------------------------------------------------------------------
+#endif // OPENSTEER_BATCHRUNNER_H
@@ -41,6 +41,12 @@
 // Usage: allocate a clock, set its "paused" or "targetFPS" parameters, then
 // call updateGlobalSimulationClock before each simulation step.
 //
+// Time is kept internally as 64 bit integer nanosecond ticks read from
+// std::chrono::steady_clock, so resolution does not degrade with uptime.
+// The float accessors (in seconds) are derived from those ticks.  Every
+// update also records frame time, simulation (non-wait) time and wait time
+// into histograms which can be queried for percentiles at runtime.
+//
 // 10-04-04 bk:  put everything into the OpenSteer namespace
 // 11-11-03 cwr: another overhaul: support aniamtion mode, switch to
 //               functional API, move smoothed stats inside this class
@@ -55,12 +61,10 @@
 #define OPENSTEER_CLOCK_H
 
 #include "OpenSteer/Utilities.h"
+#include "OpenSteer/Histogram.h"
 
-#if defined (_XBOX)
-	#include <xtl.h>
-#elif defined (_WIN32)
-	#include <windows.h>
-#endif
+#include <stdint.h>
+#include <chrono>
 
 
 namespace OpenSteer {
@@ -69,6 +73,18 @@ namespace OpenSteer {
     {
     public:
 
+        // clock time is measured in integer nanosecond ticks
+        typedef int64_t Ticks;
+        static const Ticks ticksPerSecond = 1000000000;
+        static float ticksToSeconds (const Ticks t)
+        {
+            return (float) ((double) t / (double) ticksPerSecond);
+        }
+        static Ticks secondsToTicks (const float s)
+        {
+            return (Ticks) ((double) s * (double) ticksPerSecond);
+        }
+
         // constructor
         Clock ();
 
@@ -79,6 +95,9 @@ namespace OpenSteer {
         // since the clock was first updated.
         float realTimeSinceFirstClockUpdate (void);
 
+        // same, as integer ticks (full resolution)
+        Ticks realTicksSinceFirstClockUpdate (void);
+
         // force simulation time ahead, ignoring passage of real time.
         // Used for OpenSteerDemo's "single step forward" and animation mode
         float advanceSimulationTimeOneFrame (void);
@@ -87,6 +106,17 @@ namespace OpenSteer {
         // "wait" until next frame time
         void frameRateSync (void);
 
+        // how frameRateSync waits for the next frame boundary
+        enum FrameWaitMode
+        {
+            // poll the clock in a tight loop (burns a full core while waiting)
+            spinWait,
+
+            // sleep on the monotonic clock, then spin only for the final
+            // "slack" interval before the frame boundary
+            sleepWait
+        };
+
 
         // main clock modes: variable or fixed frame rate, real-time or animation
         // mode, running or paused.
@@ -103,6 +133,10 @@ namespace OpenSteer {
 
         // is simulation running or paused?
         bool paused;
+
+        // spin or sleep while waiting for the next frame (fixed rate mode)
+        FrameWaitMode frameWaitMode;
+        float frameWaitSlack;
     public:
         int getFixedFrameRate (void) {return fixedFrameRate;}
         int setFixedFrameRate (int ffr) {return fixedFrameRate = ffr;}
@@ -114,6 +148,15 @@ namespace OpenSteer {
         bool setVariableFrameRateMode (bool vfrm)
              {return variableFrameRateMode = vfrm;}
 
+        FrameWaitMode getFrameWaitMode (void) const {return frameWaitMode;}
+        FrameWaitMode setFrameWaitMode (FrameWaitMode m)
+             {return frameWaitMode = m;}
+
+        // in sleepWait mode: how long (in seconds) before the frame boundary
+        // to wake up and switch to spinning, absorbs OS wake-up latency
+        float getFrameWaitSlack (void) const {return frameWaitSlack;}
+        float setFrameWaitSlack (float s) {return frameWaitSlack = s;}
+
         bool togglePausedState (void) {return (paused = !paused);};
         bool getPausedState (void) {return paused;};
         bool setPausedState (bool newPS) {return paused = newPS;};
@@ -129,8 +172,9 @@ namespace OpenSteer {
         void updateSmoothedRegisters (void)
         {
             const float rate = getSmoothingRate ();
-            if (elapsedRealTime > 0)
-                blendIntoAccumulator (rate, 1 / elapsedRealTime, smoothedFPS);
+            const float elapsed = getElapsedRealTime ();
+            if (elapsed > 0)
+                blendIntoAccumulator (rate, 1 / elapsed, smoothedFPS);
             if (! getVariableFrameRateMode ())
                 blendIntoAccumulator (rate, getUsage (), smoothedUsage);
         }
@@ -139,63 +183,114 @@ namespace OpenSteer {
         float getSmoothedUsage (void) const {return smoothedUsage;}
         float getSmoothingRate (void) const
         {
-            if (smoothedFPS == 0) return 1; else return elapsedRealTime * 1.5f;
+            if (smoothedFPS == 0) return 1;
+            else return ticksToSeconds (elapsedRealTime) * 1.5f;
         }
         float getUsage (void)
         {
             // run time per frame over target frame time (as a percentage)
-            return ((100 * elapsedNonWaitRealTime) / (1.0f / fixedFrameRate));
+            return ((100 * getElapsedNonWaitRealTime ()) /
+                    (1.0f / fixedFrameRate));
         }
 
 
+        // per-frame histograms of real frame time, simulation ("non-wait")
+        // time and time spent waiting for the frame boundary, in ticks.
+        // Unlike the smoothed registers these preserve the tail.
+    private:
+        Histogram frameTimeHistogram;
+        Histogram nonWaitTimeHistogram;
+        Histogram waitTimeHistogram;
+        void recordFrameHistograms (void);
+    public:
+        const Histogram& getFrameTimeHistogram (void) const
+            {return frameTimeHistogram;}
+        const Histogram& getNonWaitTimeHistogram (void) const
+            {return nonWaitTimeHistogram;}
+        const Histogram& getWaitTimeHistogram (void) const
+            {return waitTimeHistogram;}
+        void resetHistograms (void);
+
+        // frame time (in seconds) at a given percentile (0..100), for
+        // example getFrameTimePercentile (99.9)
+        float getFrameTimePercentile (const double p) const
+            {return ticksToSeconds (frameTimeHistogram.valueAtPercentile (p));}
+        float getNonWaitTimePercentile (const double p) const
+            {return ticksToSeconds (nonWaitTimeHistogram.valueAtPercentile (p));}
+        float getWaitTimePercentile (const double p) const
+            {return ticksToSeconds (waitTimeHistogram.valueAtPercentile (p));}
+
+        // print p50/p99/p999 of all three histograms
+        void printHistogramSummary (std::ostream& o) const;
+
+
         // clock state member variables and public accessors for them
     private:
         // real "wall clock" time since launch
-        float totalRealTime;
+        Ticks totalRealTime;
 
         // total time simulation has run
-        float totalSimulationTime;
+        Ticks totalSimulationTime;
 
         // total time spent paused
-        float totalPausedTime;
+        Ticks totalPausedTime;
 
         // sum of (non-realtime driven) advances to simulation time
-        float totalAdvanceTime;
+        Ticks totalAdvanceTime;
 
         // interval since last simulation time
         // (xxx does this need to be stored in the instance? xxx)
-        float elapsedSimulationTime;
+        Ticks elapsedSimulationTime;
 
         // interval since last clock update time 
         // (xxx does this need to be stored in the instance? xxx)
-        float elapsedRealTime;
+        Ticks elapsedRealTime;
 
         // interval since last clock update,
         // exclusive of time spent waiting for frame boundary when targetFPS>0
-        float elapsedNonWaitRealTime;
+        Ticks elapsedNonWaitRealTime;
     public:
-        float getTotalRealTime (void) {return totalRealTime;}
-        float getTotalSimulationTime (void) {return totalSimulationTime;}
-        float getTotalPausedTime (void) {return totalPausedTime;}
-        float getTotalAdvanceTime (void) {return totalAdvanceTime;}
-        float getElapsedSimulationTime (void) {return elapsedSimulationTime;}
-        float getElapsedRealTime (void) {return elapsedRealTime;}
-        float getElapsedNonWaitRealTime (void) {return elapsedNonWaitRealTime;}
+        float getTotalRealTime (void) {return ticksToSeconds (totalRealTime);}
+        float getTotalSimulationTime (void) {return ticksToSeconds (totalSimulationTime);}
+        float getTotalPausedTime (void) {return ticksToSeconds (totalPausedTime);}
+        float getTotalAdvanceTime (void) {return ticksToSeconds (totalAdvanceTime);}
+        float getElapsedSimulationTime (void) {return ticksToSeconds (elapsedSimulationTime);}
+        float getElapsedRealTime (void) const {return ticksToSeconds (elapsedRealTime);}
+        float getElapsedNonWaitRealTime (void) const {return ticksToSeconds (elapsedNonWaitRealTime);}
+
+
+        // wake-up jitter: how late (in seconds) frameRateSync returned
+        // relative to the frame boundary it was waiting for.  Used to verify
+        // that sleeping does not degrade frame timing compared to spinning.
+    private:
+        int wakeJitterCount;
+        Ticks wakeJitterSum;
+        Ticks wakeJitterMin;
+        Ticks wakeJitterMax;
+        void recordWakeJitter (const Ticks lateness);
+    public:
+        int getWakeJitterCount (void) const {return wakeJitterCount;}
+        float getWakeJitterMin (void) const {return ticksToSeconds (wakeJitterMin);}
+        float getWakeJitterMax (void) const {return ticksToSeconds (wakeJitterMax);}
+        float getWakeJitterMean (void) const
+        {
+            return (wakeJitterCount ?
+                    ticksToSeconds (wakeJitterSum) / wakeJitterCount :
+                    0);
+        }
+        void resetWakeJitter (void);
 
 
     private:
+        // wait (sleeping and/or spinning) until the given real time
+        void waitUntilRealTime (const Ticks targetTime);
+
         // "manually" advance clock by this amount on next update
-        float newAdvanceTime;
-
-        // "Calendar time" when this clock was first updated
-    #ifdef _WIN32
-        // from QueryPerformanceCounter on Windows
-        LONGLONG basePerformanceCounter;
-    #else
-        // from gettimeofday on Linux and Mac OS X
-        int baseRealTimeSec;
-        int baseRealTimeUsec;
-    #endif
+        Ticks newAdvanceTime;
+
+        // steady_clock time when this clock was first updated
+        std::chrono::steady_clock::time_point baseRealTime;
+        bool baseRealTimeSet;
     };
 
 } // namespace OpenSteer
@@ -0,0 +1,242 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// ControlServer: drive a running simulation from another local process
+//
+// A service thread listens on a Unix domain socket.  A client sends
+// requests, each a batch of fixed size binary commands, and gets one
+// response per request:
+//
+//     request:   RequestHeader, commandCount x Command
+//     response:  ResponseHeader, then for each queryRegion command in the
+//                request: uint32_t n, n x AgentRecord
+//
+// Commands that change the world (setTarget, spawn, despawn) are put on a
+// lock-free queue (see SpscQueue.h) which the simulation drains between
+// steps with pollCommand, so they take effect at a step boundary and the
+// simulation never waits on a client or a lock.  If the queue is full, or
+// a spawn asks for more than maxSpawn pursuers, a command is rejected
+// (counted in the response).  So is any command whose x or z is not
+// finite, and a query whose radius is negative or not finite.
+//
+// Queries are answered by the service thread from the latest snapshot the
+// simulation published with beginPublish/endPublish (a triple buffer: the
+// simulation always has a free buffer to fill, and the service thread
+// always has a whole, consistent one to read), so any amount of query
+// load leaves stepping unaffected.  Query results refer to the frame in
+// the response header.  A response carries at most maxRecords agent
+// records in all; queries past that are cut short and counted as
+// truncated.
+//
+// Client sockets are non-blocking and each client's partial request and
+// unsent response are buffered, so a slow or stalled client only delays
+// itself (its next request is not read until it has taken the last
+// response), never the other clients or close.
+//
+// Everything is in native byte order, clients are expected to be on the
+// same machine.  POSIX only.
+//
+// Usage:
+//         ControlServer control;
+//         control.open ("/tmp/opensteer.sock");
+//         each step:
+//             ...step...
+//             ControlServer::Snapshot& s = control.beginPublish ();
+//             s.frame = frame; ...fill s.handles and s.positions...
+//             control.endPublish ();
+//             Control::Command c;
+//             while (control.pollCommand (c)) ...apply c...;
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#ifndef OPENSTEER_CONTROLSERVER_H
+#define OPENSTEER_CONTROLSERVER_H
+
+
+#include "OpenSteer/HandleMap.h"
+#include "OpenSteer/SpatialGrid.h"
+#include "OpenSteer/SpscQueue.h"
+
+#include <atomic>
+#include <stdint.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+namespace OpenSteer {
+
+    namespace Control {
+
+        // "OSCR" / "OSCA" in native byte order
+        const uint32_t requestMagic = 0x5243534f;
+        const uint32_t responseMagic = 0x4143534f;
+
+        // a request holds at most this many commands
+        const uint32_t maxCommands = 65536;
+
+        // a spawn command adds at most this many pursuers
+        const uint32_t maxSpawn = 1024;
+
+        // a response holds at most this many agent records
+        const uint32_t maxRecords = 1 << 20;
+
+        enum CommandType
+        {
+            setTarget = 1,      // move wanderer "arg" to (x, z)
+            spawn = 2,          // add "count" pursuers of population "arg"
+            despawn = 3,        // remove the pursuer with handle
+                                // (arg, count) = (index, generation)
+            queryRegion = 4     // pursuers within radius of (x, z)
+        };
+
+        struct Command
+        {
+            uint32_t type;      // CommandType
+            uint32_t arg;
+            uint32_t count;
+            float x, z;
+            float radius;
+        };
+
+        struct RequestHeader
+        {
+            uint32_t magic;     // requestMagic
+            uint32_t commandCount;
+        };
+
+        struct ResponseHeader
+        {
+            uint32_t magic;     // responseMagic
+            uint32_t queued;    // commands queued for the next step
+            uint32_t rejected;  // commands dropped: queue full, invalid or unknown
+            uint32_t queries;   // query results following
+            uint32_t truncated; // queries cut short at maxRecords
+            uint32_t records;   // agent records in all query results
+            uint64_t frame;     // snapshot the queries were answered from
+        };
+
+        struct AgentRecord
+        {
+            uint32_t index;     // handle
+            uint32_t generation;
+            float x, z;
+        };
+
+    } // namespace Control
+
+
+    class ControlServer
+    {
+    public:
+
+        // pursuers' handles and positions at the end of a step
+        struct Snapshot
+        {
+            uint64_t frame;
+            std::vector<Handle> handles;
+            std::vector<Vec3> positions;
+        };
+
+        // queueCapacity: commands that can wait for the next step
+        ControlServer (const size_t queueCapacity = 4096);
+        ~ControlServer (void);
+
+        // listen on a socket at path (replacing any stale one) and start
+        // the service thread, returns false (with a message on std::cerr)
+        // on failure
+        bool open (const std::string& path);
+
+        // stop the service thread, disconnect clients, remove the socket
+        void close (void);
+
+        bool isOpen (void) const {return listener >= 0;}
+
+        // simulation thread: the next queued command, false if none
+        bool pollCommand (Control::Command& c) {return commands.pop (c);}
+
+        // simulation thread: fill the returned snapshot, then publish it
+        Snapshot& beginPublish (void) {return snapshots[back];}
+        void endPublish (void);
+
+    private:
+
+        // a connected client: its partial request and unsent response
+        struct Client
+        {
+            int fd;
+            std::vector<unsigned char> input;
+            std::vector<unsigned char> output;
+            size_t sent;
+        };
+
+        // service thread
+        void serve (void);
+        bool receive (Client& client);
+        bool flush (Client& client);
+        bool handleRequests (Client& client);
+        // the response to commandCount commands at request
+        void answer (const unsigned char* request,
+                     const size_t commandCount,
+                     std::vector<unsigned char>& response);
+        void takeLatestSnapshot (void);
+
+        SpscQueue<Control::Command> commands;
+
+        // triple buffer: the simulation fills "back", the service thread
+        // reads "front", "middle" holds the latest published (with a
+        // fresh flag) and is exchanged by either side
+        Snapshot snapshots[3];
+        int back;
+        int front;
+        std::atomic<int> middle;
+        static const int fresh = 4;
+
+        // service thread: index over the front snapshot, and a buffer
+        SpatialGrid grid;
+        std::vector<int> found;
+
+        std::string socketPath;
+        int listener;
+        std::vector<Client> clients;
+        std::thread service;
+        std::atomic<bool> stopping;
+
+        // not copyable
+        ControlServer (const ControlServer&);
+        ControlServer& operator= (const ControlServer&);
+    };
+
+} // namespace OpenSteer
+
+
+// ----------------------------------------------------------------------------
+#endif // OPENSTEER_CONTROLSERVER_H
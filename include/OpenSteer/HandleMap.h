@@ -0,0 +1,199 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// HandleMap: dense array of values addressed by stable generational handles
+//
+// A Handle is a slot index plus the generation of that slot when the value
+// was inserted.  Removing a value bumps its slot's generation, so handles
+// to it go stale and are safely rejected (get returns NULL) rather than
+// referring to whatever reuses the slot later.  Free slots form an
+// intrusive list, making insert and remove O(1).  Values live in one dense
+// array, kept packed by swap-remove (the last value moves into the hole),
+// so iterating all values is a linear walk with no gaps.
+//
+// Usage:
+//         HandleMap<MpPursuer*> pursuers;
+//         const Handle h = pursuers.insert (p);
+//         ...
+//         if (MpPursuer** p = pursuers.get (h)) ...
+//         pursuers.remove (h);
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#ifndef OPENSTEER_HANDLEMAP_H
+#define OPENSTEER_HANDLEMAP_H
+
+
+#include "OpenSteer/StandardTypes.h"
+
+#include <stdint.h>
+#include <vector>
+
+
+namespace OpenSteer {
+
+    struct Handle
+    {
+        uint32_t index;
+        uint32_t generation;   // never 0 for a handle returned by insert
+
+        Handle (void) : index (0), generation (0) {}
+        Handle (uint32_t i, uint32_t g) : index (i), generation (g) {}
+
+        bool isNull (void) const {return generation == 0;}
+        bool operator== (const Handle& h) const
+        {
+            return index == h.index && generation == h.generation;
+        }
+        bool operator!= (const Handle& h) const {return ! (*this == h);}
+    };
+
+
+    template <class T>
+    class HandleMap
+    {
+    public:
+
+        HandleMap (void) : freeHead (noSlot) {}
+
+        // room for n values without reallocation
+        void reserve (const size_t n)
+        {
+            slots.reserve (n);
+            values.reserve (n);
+            valueSlot.reserve (n);
+        }
+
+        // add a value, returns its handle
+        Handle insert (const T& value)
+        {
+            uint32_t index;
+            if (freeHead != noSlot)
+            {
+                index = freeHead;
+                freeHead = slots[index].dense;
+            }
+            else
+            {
+                index = (uint32_t) slots.size ();
+                slots.push_back (Slot ());
+                slots.back().generation = 1;
+            }
+            slots[index].dense = (uint32_t) values.size ();
+            values.push_back (value);
+            valueSlot.push_back (index);
+            return Handle (index, slots[index].generation);
+        }
+
+        // remove the value a handle refers to, the last value in the dense
+        // array moves into its place.  Returns false for a stale handle.
+        bool remove (const Handle h)
+        {
+            if (! valid (h)) return false;
+
+            Slot& slot = slots[h.index];
+            const uint32_t hole = slot.dense;
+            const uint32_t last = (uint32_t) values.size () - 1;
+            values[hole] = values[last];
+            valueSlot[hole] = valueSlot[last];
+            slots[valueSlot[hole]].dense = hole;
+            values.pop_back ();
+            valueSlot.pop_back ();
+
+            // retire the slot's generation (skipping 0, the null handle)
+            if (++slot.generation == 0) slot.generation = 1;
+            slot.dense = freeHead;
+            freeHead = h.index;
+            return true;
+        }
+
+        // does this handle refer to a live value?
+        bool valid (const Handle h) const
+        {
+            return (h.index < slots.size () &&
+                    h.generation != 0 &&
+                    slots[h.index].generation == h.generation);
+        }
+
+        // the value a handle refers to, or NULL for a stale handle
+        T* get (const Handle h)
+        {
+            return valid (h) ? &values[slots[h.index].dense] : 0;
+        }
+
+        // position of a live handle's value in the dense array
+        size_t denseIndex (const Handle h) const
+        {
+            return slots[h.index].dense;
+        }
+
+        // handle of the value at a position in the dense array
+        Handle handleAt (const size_t denseIndex) const
+        {
+            const uint32_t index = valueSlot[denseIndex];
+            return Handle (index, slots[index].generation);
+        }
+
+        // dense array access
+        size_t size (void) const {return values.size ();}
+        T& operator[] (const size_t denseIndex) {return values[denseIndex];}
+        const T& operator[] (const size_t denseIndex) const
+        {
+            return values[denseIndex];
+        }
+
+        // remove everything, invalidating all outstanding handles
+        void clear (void)
+        {
+            while (! values.empty ()) remove (handleAt (values.size () - 1));
+        }
+
+    private:
+
+        static const uint32_t noSlot = 0xffffffff;
+
+        struct Slot
+        {
+            uint32_t dense;        // value index, or next free slot
+            uint32_t generation;
+        };
+
+        std::vector<Slot> slots;
+        uint32_t freeHead;
+        std::vector<T> values;
+        std::vector<uint32_t> valueSlot;   // dense index -> slot index
+    };
+
+} // namespace OpenSteer
+
+
+// ----------------------------------------------------------------------------
+#endif // OPENSTEER_HANDLEMAP_H
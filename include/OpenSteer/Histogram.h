@@ -0,0 +1,103 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// Histogram: HDR-style (log-linear bucketed) histogram of integer samples
+//
+// Records non-negative 64 bit samples (typically Clock ticks) into a fixed
+// set of buckets: values below 2*subBucketCount are recorded exactly, above
+// that each power-of-two range is split into subBucketCount linear buckets,
+// giving a relative precision of better than 1/subBucketCount across the
+// whole range.  Recording is O(1) and never allocates, so it is suitable for
+// once-per-frame use; percentile queries walk the buckets.
+//
+// Usage:
+//         Histogram h;
+//         h.record (frameTicks);
+//         const int64_t p99 = h.valueAtPercentile (99.0);
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#ifndef OPENSTEER_HISTOGRAM_H
+#define OPENSTEER_HISTOGRAM_H
+
+
+#include <stdint.h>
+#include <vector>
+
+
+namespace OpenSteer {
+
+    class Histogram
+    {
+    public:
+
+        // constructor: samples larger than maxTrackableValue are clamped
+        // to it (default is about 68 seconds of nanosecond ticks)
+        Histogram (const int64_t maxTrackableValue = (int64_t) 1 << 36);
+
+        // add one sample
+        void record (int64_t value);
+
+        // forget all samples
+        void reset (void);
+
+        // summary statistics of recorded samples (0 when empty)
+        int64_t count (void) const {return _count;}
+        int64_t min (void) const {return _count ? _min : 0;}
+        int64_t max (void) const {return _count ? _max : 0;}
+        double mean (void) const {return _count ? _sum / (double) _count : 0;}
+
+        // the smallest recorded value such that the given percentage (0..100)
+        // of all samples are less than or equal to it, reported as the upper
+        // edge of its bucket (exact for min/max, 0 when empty)
+        int64_t valueAtPercentile (const double percentile) const;
+
+    private:
+
+        // log-linear bucket mapping
+        static const int subBucketBits = 7;
+        static const int subBucketCount = 1 << subBucketBits;
+        static int bucketIndex (const int64_t value);
+        static int64_t bucketHighestValue (const int index);
+
+        int64_t _maxTrackableValue;
+        std::vector<int64_t> _buckets;
+        int64_t _count;
+        int64_t _min;
+        int64_t _max;
+        double _sum;
+    };
+
+} // namespace OpenSteer
+
+
+// ----------------------------------------------------------------------------
+#endif // OPENSTEER_HISTOGRAM_H
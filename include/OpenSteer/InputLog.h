@@ -0,0 +1,131 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// InputLog: recorded user input for deterministic replay
+//
+// Holds the random seed a session was started with plus a frame indexed
+// list of input events (player target changes and moves, pursuer kills
+// and spawns, and the commands of control clients, see ControlServer.h).
+// Since every vehicle's random stream derives from the seed
+// (see Random.h) and the simulation uses a fixed time step, applying the
+// same events on the same frames reproduces the session's trajectories
+// exactly, independent of how fast the frames are run.
+//
+// The file is a small header followed by fixed size 28 byte events in
+// native byte order.  Logs of other versions are refused.
+//
+// Usage:
+//         InputLog log;
+//         log.setSeed (randomSeed ());
+//         log.add (InputLog::Event::playerTarget, frame, time, x, z);
+//         ...
+//         log.setFrameCount (frame);
+//         log.write ("session.input");
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#ifndef OPENSTEER_INPUTLOG_H
+#define OPENSTEER_INPUTLOG_H
+
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+
+namespace OpenSteer {
+
+    class InputLog
+    {
+    public:
+
+        struct Event
+        {
+            enum Type
+            {
+                playerTarget = 1,   // set player position to (x, z)
+                playerMove = 2,     // move player position by (x, z)
+                killEnemy = 3,      // remove the pursuer nearest the player
+                spawnEnemy = 4,     // add a pursuer
+                wandererTarget = 5, // set wanderer arg's position to (x, z)
+                spawnPursuers = 6,  // add count pursuers of population arg
+                despawnPursuer = 7  // remove the pursuer of handle (arg,
+                                    // count), see Control::despawn
+            };
+
+            uint32_t frame;         // frame the event was applied after
+            uint32_t type;          // Type
+            float time;             // real seconds since recording began
+            float x, z;
+            uint32_t arg, count;
+        };
+
+        InputLog (void) : _seed (0), _frameCount (0) {}
+
+        // discard all events
+        void clear (void) {events.clear (); _frameCount = 0;}
+
+        // append an event (events must be added in frame order)
+        void add (const Event::Type type,
+                  const uint32_t frame,
+                  const float time,
+                  const float x,
+                  const float z,
+                  const uint32_t arg = 0,
+                  const uint32_t count = 0);
+
+        // seed the recorded session was started with
+        uint64_t seed (void) const {return _seed;}
+        void setSeed (const uint64_t s) {_seed = s;}
+
+        // total number of frames in the recorded session
+        uint32_t frameCount (void) const {return _frameCount;}
+        void setFrameCount (const uint32_t n) {_frameCount = n;}
+
+        // recorded events, in frame order
+        std::vector<Event> events;
+
+        // write or read a log file, returns false (with a message on
+        // std::cerr) on failure
+        bool write (const std::string& path) const;
+        bool read (const std::string& path);
+
+    private:
+
+        uint64_t _seed;
+        uint32_t _frameCount;
+    };
+
+} // namespace OpenSteer
+
+
+// ----------------------------------------------------------------------------
+#endif // OPENSTEER_INPUTLOG_H
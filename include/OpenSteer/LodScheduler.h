@@ -0,0 +1,169 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// LodScheduler: level-of-detail time slicing of agent updates
+//
+// Each frame every agent is assigned to a tier by its distance to the
+// nearest point of interest (the player, the camera...).  A tier has a
+// period k: its agents are stepped on every k-th frame only, with a time
+// step of k times the frame step, so they cover the same simulated time
+// with 1/k of the work.  Agents of a tier are staggered across the k
+// frames (by a stable agent id) so the work per frame stays even.  Tiers
+// are re-evaluated every frame, so an agent approaching a point of
+// interest moves to a finer tier immediately.  The frame each agent last
+// stepped is kept, and a step covers exactly the frames since then, so
+// changing tier neither gains nor loses simulated time.  Frames an agent
+// spends asleep or not yet spawned are not owed (see hold and restart).  Beyond a few points of interest they
+// are binned in a SpatialGrid once per frame, so tiering an agent costs a
+// nearest point query rather than a scan of every point.
+//
+// With no tiers set every agent is stepped every frame.
+//
+// Usage:
+//         scheduler.beginFrame ();
+//         scheduler.addPointOfInterest (player.position ());
+//         for (i...)
+//             if (const int k = scheduler.stepMultiplier (i, position))
+//                 agent.update (k * elapsedTime);
+//         ...
+//         scheduler.printReport (std::cout);
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#ifndef OPENSTEER_LODSCHEDULER_H
+#define OPENSTEER_LODSCHEDULER_H
+
+
+#include "OpenSteer/Vec3.h"
+#include "OpenSteer/SpatialGrid.h"
+#include "OpenSteer/StandardTypes.h"
+
+#include <iosfwd>
+#include <stdint.h>
+#include <utility>
+#include <vector>
+
+
+namespace OpenSteer {
+
+    class LodScheduler
+    {
+    public:
+
+        struct Tier
+        {
+            float maxDistance;   // agents nearer than this (and not in a
+                                 // nearer tier) belong to this tier
+            int period;          // stepped every period frames
+        };
+
+        LodScheduler (void);
+
+        // tiers in order of increasing maxDistance, agents beyond the last
+        // tier use its period.  An empty list disables LOD.
+        void setTiers (const std::vector<Tier>& t);
+        const std::vector<Tier>& getTiers (void) const {return tiers;}
+
+        // start a new frame: advances the frame counter and clears the
+        // points of interest
+        void beginFrame (void);
+
+        // agents are tiered by distance to the nearest of these
+        void addPointOfInterest (const Vec3& point);
+
+        // should this agent step this frame?  Returns the multiple of the
+        // frame time step to use (the frames since it last stepped, at
+        // most the longest tier period), or 0 to skip it.  agent is any small
+        // integer that stays the agent's for its lifetime (e.g. its handle
+        // slot, not an index that changes when other agents are removed),
+        // used to stagger the tier and to remember its last step.
+        int stepMultiplier (const size_t agent, const Vec3& position);
+
+        // the agent is not stepped this frame and owes no time for it
+        // (it is asleep)
+        void hold (const size_t agent);
+
+        // the agent (new, or reusing the id of a removed one) owes time
+        // from the next frame on
+        void restart (const size_t agent);
+
+        // forget every agent's last step (the agents were replaced)
+        void clearHistory (void) {lastStep.clear ();}
+
+        // work accounting since the last resetCounters
+        uint64_t stepsRun (void) const {return _stepsRun;}
+        uint64_t stepsSkipped (void) const {return _stepsSkipped;}
+        float savedFraction (void) const;
+        void resetCounters (void);
+
+        // one line summary: steps run and skipped, work saved, and how many
+        // agents are in each tier this frame
+        void printReport (std::ostream& o) const;
+
+    private:
+
+        // index into tiers for a position
+        size_t tierOf (const Vec3& position);
+
+        // the last step frame of an agent, a new one owing this frame only
+        uint64_t& lastStepOf (const size_t agent);
+
+        // bin this frame's points of interest, if there are enough of them
+        void indexPoints (void);
+
+        std::vector<Tier> tiers;
+        std::vector<Vec3> pointsOfInterest;
+
+        // this frame's points of interest binned (when useGrid) in cells
+        // of the farthest distance that still changes an agent's tier
+        SpatialGrid grid;
+        bool indexed;
+        bool useGrid;
+        float reach;
+        std::vector<std::pair<float, int> > nearestPoint;
+        uint64_t frame;
+        uint64_t longestPeriod;
+        uint64_t _stepsRun;
+        uint64_t _stepsSkipped;
+
+        // agents per tier this frame
+        std::vector<size_t> tierCount;
+
+        // per agent id: the frame it was last stepped, moved on by one
+        // for each frame held since
+        std::vector<uint64_t> lastStep;
+    };
+
+} // namespace OpenSteer
+
+
+// ----------------------------------------------------------------------------
+#endif // OPENSTEER_LODSCHEDULER_H
@@ -0,0 +1,179 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// Metrics: process-wide counters and gauges for production scraping
+//
+// Counters are monotonically increasing totals (Prometheus "counter"),
+// gauges are instantaneous values (Prometheus "gauge").  Both are safe to
+// update from any thread.  Counters are split into cache-line sized shards
+// indexed by thread, updated with relaxed atomics, and summed only when
+// read, so concurrent increments from hot loops do not contend.
+//
+// Metrics are registered by name once (registration takes a lock and
+// returns a reference which stays valid for the life of the process);
+// updates through that reference never lock or allocate.
+//
+// Metrics::startFileExporter runs a background thread which periodically
+// writes all metrics in Prometheus text exposition format to a file,
+// atomically (write to "<path>.tmp" then rename), suitable for the
+// node-exporter textfile collector.
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#ifndef OPENSTEER_METRICS_H
+#define OPENSTEER_METRICS_H
+
+
+#include <stdint.h>
+#include <atomic>
+#include <iostream>
+#include <string>
+
+
+namespace OpenSteer {
+
+    // ----------------------------------------------------------------------------
+    // monotonically increasing total
+
+
+    class MetricCounter
+    {
+    public:
+        MetricCounter ();
+
+        void add (const uint64_t n)
+        {
+            shards[shardIndex ()].value.fetch_add (n, std::memory_order_relaxed);
+        }
+        void increment (void) {add (1);}
+
+        // sum over all shards
+        uint64_t value (void) const;
+
+    private:
+        static const int shardCount = 16;
+        static int shardIndex (void);
+
+        struct alignas (64) Shard
+        {
+            std::atomic<uint64_t> value;
+        };
+        Shard shards[shardCount];
+    };
+
+
+    // ----------------------------------------------------------------------------
+    // instantaneous value
+
+
+    class MetricGauge
+    {
+    public:
+        MetricGauge () : _value (0) {}
+
+        void set (const double v) {_value.store (v, std::memory_order_relaxed);}
+        double value (void) const {return _value.load (std::memory_order_relaxed);}
+
+    private:
+        std::atomic<double> _value;
+    };
+
+
+    // ----------------------------------------------------------------------------
+    // the metrics OpenSteer itself maintains
+
+
+    struct StandardMetrics
+    {
+        // number of agents currently simulated
+        MetricGauge& agents;
+
+        // number of those agents which are awake (not sleeping, see
+        // Activity.h)
+        MetricGauge& activeAgents;
+
+        // total simulation frames stepped
+        MetricCounter& frames;
+
+        // total agent update steps (one per agent per frame it is updated)
+        MetricCounter& steps;
+
+        // total agent-to-agent proximity tests made by steering behaviors
+        MetricCounter& neighborQueries;
+
+        // total agent-to-obstacle tests made by steering behaviors
+        MetricCounter& obstacleTests;
+
+        // duration of the most recent spatial index rebuild
+        MetricGauge& spatialIndexRebuildSeconds;
+
+        // memory used per agent
+        MetricGauge& agentBytes;
+    };
+
+
+    // ----------------------------------------------------------------------------
+    // registry and exporter
+
+
+    class Metrics
+    {
+    public:
+        // find or create a metric (name should follow Prometheus naming,
+        // e.g. "opensteer_steps_total"; help is a one line description).
+        // A name already registered as the other type is reported on
+        // std::cerr and gets a detached metric which is never exported.
+        static MetricCounter& counter (const std::string& name,
+                                       const std::string& help);
+        static MetricGauge& gauge (const std::string& name,
+                                   const std::string& help);
+
+        // OpenSteer's own metrics (registered on first call)
+        static StandardMetrics& standard (void);
+
+        // write all metrics in Prometheus text exposition format
+        static void writePrometheus (std::ostream& o);
+
+        // write them to a file atomically, returns false on I/O error
+        static bool writePrometheusFile (const std::string& path);
+
+        // start/stop a background thread which rewrites the file every
+        // intervalSeconds (stop also writes one final time)
+        static void startFileExporter (const std::string& path,
+                                       const float intervalSeconds);
+        static void stopFileExporter (void);
+    };
+
+} // namespace OpenSteer
+
+
+// ----------------------------------------------------------------------------
+#endif // OPENSTEER_METRICS_H
@@ -0,0 +1,444 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// MultiplePursuit: a self-contained world of wanderers and their pursuers
+//
+// MpWorld owns one or more wanderers (quarries; the first is the player's)
+// and any number of pursuers, each chasing its nearest wanderer.  It has no
+// global state: the vehicles' random streams derive from the world's own
+// seed, and publishing to the global Metrics can be turned off, so any
+// number of worlds can be stepped independently, on any threads (one
+// thread per world at a time).
+//
+// A step runs in five phases: rebuild (despawns, quarry states, targets,
+// LOD and wake decisions), steer, avoid (optional ORCA avoidance between
+// pursuers, see OrcaSolver.h) and integrate (per pursuer, independent of
+// each other, so run in parallel when the world is given a TaskScheduler)
+// and end (captures and respawns).  update_enemies runs them all, a
+// FrameGraph can run them as separate phases.
+//
+// Usage:
+//         MpWorld world;
+//         world.configure (scenario);
+//         world.setSeed (42);
+//         world.open ();
+//         for (...) world.update_enemies (elapsedTime);
+//         world.close ();
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#ifndef OPENSTEER_MULTIPLEPURSUIT_H
+#define OPENSTEER_MULTIPLEPURSUIT_H
+
+
+#include "OpenSteer/SimpleVehicle.h"
+#include "OpenSteer/Scenario.h"
+#include "OpenSteer/HandleMap.h"
+#include "OpenSteer/Arena.h"
+#include "OpenSteer/LodScheduler.h"
+#include "OpenSteer/Activity.h"
+#include "OpenSteer/SpatialGrid.h"
+#include "OpenSteer/TaskScheduler.h"
+#include "OpenSteer/OrcaSolver.h"
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+
+namespace OpenSteer {
+
+    // ----------------------------------------------------------------------------
+    // two vehicle types: MpWanderer and MpPursuer.  They have a common base
+    // class, MpBase, which is a specialization of SimpleVehicle.
+
+
+    class MpBase : public SimpleVehicle
+    {
+    public:
+
+        // constructor
+        MpBase () {
+            reset ();
+        }
+
+        // constructor: directly in a saved state
+        explicit MpBase (const State& s) : SimpleVehicle (s) {}
+
+        // reset state
+        void reset (void)
+        {
+            SimpleVehicle::reset (); // reset the vehicle
+            setSpeed (0);            // speed along Forward direction.
+            setMaxForce (5.0);       // steering force is clipped to this magnitude
+            setMaxSpeed (3.0);       // velocity is clipped to this magnitude
+            clearTrailHistory ();    // prevent long streaks due to teleportation
+        }
+
+    };
+
+
+    class MpWanderer : public MpBase
+    {
+    public:
+
+        // constructor
+        MpWanderer () {
+            reset ();
+        }
+
+        // constructor: directly in a saved state
+        explicit MpWanderer (const State& s) : MpBase (s) {}
+
+        // reset state
+        void reset (void)
+        {
+            MpBase::reset ();
+        }
+
+        // one simulation step
+        void update (const float elapsedTime, Vec3 location)
+        {
+            const Vec3 wander2d = location;//steerForWander (elapsedTime).setYtoZero ();
+            const Vec3 steer = forward() + (wander2d * 3);
+            applySteeringForce (steer, elapsedTime);
+        }
+
+    };
+
+
+    class MpPursuer : public MpBase
+    {
+        const std::vector<QuarryState>* quarries;   // wanderers, this frame
+        size_t target;                              // index of the one chased
+        const Scenario::Population* population;
+        bool captured;
+        float lastSteeringForce;
+    public:
+
+        // sleep/wake state, maintained by MpWorld
+        Activity activity;
+
+        // constructor: chases quarries[t], random stream "stream" of seed
+        MpPursuer (const std::vector<QuarryState>* q,
+                   const size_t t,
+                   const Scenario::Population* p,
+                   const uint64_t seed,
+                   const uint64_t stream);
+
+        // constructor: chases quarries[t], directly in a saved state
+        // (which includes its random stream), without placing it
+        MpPursuer (const std::vector<QuarryState>* q,
+                   const size_t t,
+                   const Scenario::Population* p,
+                   const SimpleVehicle::State& s);
+
+        // move to another population (takes effect on the next reset)
+        void setPopulation (const Scenario::Population* p) {population = p;}
+        const Scenario::Population* getPopulation (void) const {return population;}
+
+        // index (into the quarry states) of the wanderer this pursuer chases
+        void setTarget (const size_t t) {target = t;}
+        size_t getTarget (void) const {return target;}
+
+        // did this pursuer touch its target during its last update?
+        bool isCaptured (void) const {return captured;}
+
+        // magnitude of the steering force applied by the last update
+        float getLastSteeringForce (void) const {return lastSteeringForce;}
+
+        // reset state
+        void reset (void);
+
+        // reinitialize from a freshly reset pursuer's state (keeping our own
+        // random stream) then place on the spawn ring, cheaper than reset ()
+        void respawn (const SimpleVehicle::State& prototype);
+
+        // one simulation step chasing the given quarry (the target's
+        // state), MpWorld calls this for all pursuers of one target in a
+        // batch
+        void pursue (const QuarryState& quarry, const float elapsedTime)
+        {
+            applyPursuit (pursuitSteering (quarry), elapsedTime);
+        }
+
+        // the two halves of pursue: the steering force toward the quarry
+        // (also noting capture), and applying it
+        Vec3 pursuitSteering (const QuarryState& quarry);
+        void applyPursuit (const Vec3& steer, const float elapsedTime);
+
+        // one simulation step
+        void update (const float elapsedTime, Vec3 /*location*/)
+        {
+            pursue ((*quarries)[target], elapsedTime);
+        }
+
+        // reset position
+        void randomizeStartingPositionAndHeading (void);
+    };
+
+
+    // ----------------------------------------------------------------------------
+
+
+    class MpWorld
+    {
+    public:
+
+        MpWorld (void);
+        ~MpWorld (void);
+
+        // take populations, wanderer layout, LOD tiers and sleep thresholds
+        // from a scenario (takes effect on the next open)
+        void configure (const Scenario& scenario);
+
+        // the parts of configure, individually
+        void setPopulations (const std::vector<Scenario::Population>& p);
+        void setWanderers (const int count, const float spread, const int frames);
+        void setLodTiers (const std::vector<LodScheduler::Tier>& tiers);
+        void setSleepThresholds (const Activity::Thresholds& t);
+        void setAvoidance (const OrcaSolver::Options& o) {orca.setOptions (o);}
+
+        // seed for all of this world's random streams (takes effect on the
+        // next open), by default the global randomSeed () at open
+        void setSeed (const uint64_t s);
+        uint64_t getSeed (void) const {return seed;}
+
+        // whether to update the global standard Metrics (default true),
+        // worlds run in bulk turn this off.  Applies to the world's
+        // vehicles' steering behaviors too.
+        void setPublishMetrics (const bool p);
+
+        // create and destroy the vehicles
+        void open (void);
+        void close (void);
+
+        // reset (and so wake) wanderers and pursuers
+        void reset (void);
+
+        // run the steer and integrate phases on a scheduler's threads
+        // (default null: on the calling thread).  Results do not depend on
+        // the number of threads.
+        void setScheduler (TaskScheduler* s) {scheduler = s;}
+
+        // one simulation step of all pursuers: the phases in order
+        void update_enemies (const float elapsedTime);
+
+        // the phases of a step, see above
+        void beginStep (const float elapsedTime);
+        void steer (void);
+        void avoid (void);
+        void integrate (void);
+        void endStep (void);
+
+        // move the player's wanderer
+        void update_hero (const float elapsedTime, Vec3 location);
+
+        // add a pursuer of the given population, O(1)
+        Handle spawnPursuer (const size_t population);
+
+        // remove a pursuer at the next step boundary, so it is safe to call
+        // during a step.  Stale handles are ignored.
+        void despawnPursuer (const Handle h);
+
+        // explicit wake triggers
+        void wakePursuer (const Handle h);
+        void wakeAllPursuers (void);
+
+        // handle of the pursuer closest to the player's wanderer (null if
+        // none)
+        Handle nearestPursuer (void);
+
+        // all vehicles: the wanderers, then the pursuers
+        AVGroup allVehicles (void) const {return AVGroup (allMP.begin (), allMP.end ());}
+        const std::vector<MpBase*>& vehicles (void) const {return allMP;}
+
+        // the player's wanderer, and any wanderer
+        MpWanderer* getWanderer (void) {return wanderers.front ();}
+        MpWanderer* getWanderer (const size_t w) {return wanderers[w];}
+        size_t getWandererCount (void) const {return wanderers.size ();}
+        size_t getPursuerCount (void) const {return pursuers.size ();}
+        size_t getPopulationCount (void) const {return populations.size ();}
+
+        // handle of the pursuer at a dense index (its vehicle is
+        // vehicles ()[getWandererCount () + i])
+        Handle pursuerHandle (const size_t i) const {return pursuers.handleAt (i);}
+
+        // total pursuer update steps run since open
+        uint64_t agentSteps (void) const {return lod.stepsRun ();}
+
+        void printLodReport (std::ostream& o) const {lod.printReport (o);}
+
+        // save / restore the state of every vehicle (wanderers first) and
+        // each pursuer's target, population and sleep state, see
+        // Snapshot.h.  Loading rebuilds the world first if the snapshot
+        // holds a different number of wanderers or pursuers (creating the
+        // vehicles directly in their saved states), and refuses
+        // (false, with a message on std::cerr) a snapshot of a world with
+        // a different number of populations.
+        bool saveSnapshot (const std::string& path,
+                           uint64_t frame,
+                           double simulationTime);
+        bool loadSnapshot (const std::string& path);
+
+    private:
+
+        // apply pending despawns, each O(1): the last pursuer moves into
+        // the hole, in both the handle map and allMP
+        void applyDespawns (void);
+
+        // capture every wanderer's state once and rebuild the index over
+        // them
+        void captureQuarries (void);
+
+        // point the next slice of pursuers at their nearest wanderer, so
+        // every pursuer is reconsidered once per reassignFrames steps
+        void reassignTargets (void);
+
+        // group pursuers' dense indices by target with a counting sort
+        void groupByTarget (void);
+
+        // batched respawn phase: reinitialize this step's captured pursuers
+        void respawnCaptured (const size_t captureCount);
+
+        // build each population's respawn prototype
+        void buildRespawnPrototypes (void);
+
+        // replace all vehicles with new ones in the given states (the
+        // first wandererCount are wanderers), as loadSnapshot does when
+        // the counts differ.  Pursuers' roles are left to the caller.
+        void createFromStates (const std::vector<SimpleVehicle::State>& states);
+
+        // one pursuer's update this step, in target order: which pursuer,
+        // how long a step it takes (LOD) and its steering force
+        struct StepJob
+        {
+            MpPursuer* pursuer;
+            size_t index;
+            size_t target;
+            float elapsedTime;
+            Vec3 steer;
+        };
+        std::vector<StepJob> jobs;
+
+        // pursuers per task in the parallel phases
+        static const size_t jobGrain = 256;
+        TaskScheduler* scheduler;
+
+        // counts taken in beginStep, published by endStep
+        uint64_t stepsBefore;
+        size_t awakeCount;
+
+        // avoidance: all pursuers' state by dense index, the jobs' indices,
+        // (LOD) step lengths and avoiding velocities
+        OrcaSolver orca;
+        std::vector<Vec3> avoidPosition;
+        std::vector<Vec3> avoidVelocity;
+        std::vector<Vec3> avoidPreferred;
+        std::vector<float> avoidRadius;
+        std::vector<float> avoidMaxSpeed;
+        std::vector<size_t> avoidActive;
+        std::vector<float> avoidStep;
+        std::vector<Vec3> avoidResult;
+
+        // a group (STL vector) of all vehicles: the wanderers, then the
+        // pursuers in the same order as the dense array of "pursuers"
+        std::vector<MpBase*> allMP;
+
+        // the wanderers (the first is the player's) and their states,
+        // captured once per step for all pursuers
+        std::vector<MpWanderer*> wanderers;
+        std::vector<QuarryState> quarries;
+
+        // index over wanderer positions, rebuilt each step, used to assign
+        // each pursuer its nearest wanderer as target.  Reassignment is
+        // spread over several steps: each step the next slice of pursuers
+        // is done.
+        SpatialGrid quarryGrid;
+        std::vector<Vec3> quarryPositions;
+        size_t reassignCursor;
+
+        // pursuers' dense indices grouped by target (counting sort), so
+        // each target's state is loaded once for its whole group, and the
+        // sort's next free slot per target
+        std::vector<size_t> targetStart;
+        std::vector<size_t> byTarget;
+        std::vector<size_t> targetCursor;
+
+        // live pursuers by handle, despawns requested since the last step,
+        // and despawned pursuer objects kept for reuse by the next spawn
+        HandleMap<MpPursuer*> pursuers;
+        std::vector<Handle> pendingDespawn;
+        std::vector<MpPursuer*> deadPursuers;
+
+        // dense indices of pursuers captured during this step, and the
+        // state of a freshly reset pursuer of each population to respawn
+        // them from
+        std::vector<size_t> captures;
+        std::vector<SimpleVehicle::State> respawnPrototypes;
+
+        // time slices distant pursuers' updates (see Scenario's lod_tier)
+        LodScheduler lod;
+
+        // when pursuers fall asleep and what wakes them (see Activity.h)
+        Activity::Thresholds sleep;
+
+        // vehicles are built in place here and released in bulk on close
+        Arena<MpWanderer> wandererArena;
+        Arena<MpPursuer> pursuerArena;
+
+        int pursuerCount;
+
+        // pursuer populations and wanderer layout, see Scenario.h
+        std::vector<Scenario::Population> populations;
+        int wandererCount;
+        float wandererSpread;
+        int reassignFrames;
+
+        // random streams: this world's seed, whether it was set, and the
+        // stream number for the next new pursuer (which also numbers its
+        // serialNumber, after the wanderers')
+        uint64_t seed;
+        bool seedSet;
+        uint64_t nextStream;
+
+        bool publishMetrics;
+
+        // not copyable: vehicles refer to the world's quarry states
+        MpWorld (const MpWorld&);
+        MpWorld& operator= (const MpWorld&);
+    };
+
+} // namespace OpenSteer
+
+
+// ----------------------------------------------------------------------------
+#endif // OPENSTEER_MULTIPLEPURSUIT_H
@@ -0,0 +1,187 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// OpenSteerC: C interface for embedding the steering engine
+//
+// A stable C ABI (built as the shared library opensteer_c) over a world of
+// wanderers and the pursuers chasing them (see MultiplePursuit.h), for
+// host engines and other languages.  Calls are per world and per batch,
+// never per agent: agents are added in bulk, a call steps any number of
+// frames, and state moves through caller provided arrays or is read in
+// place.
+//
+// Agents are the pursuers, indexed 0 .. opensteer_agent_count () - 1 in
+// the order they were added.  Positions and velocities are 3 floats per
+// agent (x, y, z).  A world is not thread safe: call it from one thread
+// at a time (it steps on its own worker threads, see config.threads).
+//
+// Zero-copy reads: opensteer_view fills in pointers to the world's own
+// structure-of-arrays copy of agent state, refreshed by every call that
+// changes it (opensteer_step, opensteer_add_agents, opensteer_set_*).
+// They stay valid until the next call that steps, adds agents or destroys
+// the world, and are read-only: change state with opensteer_set_positions
+// / opensteer_set_velocities.
+//
+// Functions returning int return OPENSTEER_OK (0) or a negative
+// OPENSTEER_ERROR_* code.  No C++ exception leaves the library: failures
+// inside it are reported as OPENSTEER_ERROR_MEMORY or
+// OPENSTEER_ERROR_INTERNAL (NULL from opensteer_create).
+//
+// Usage:
+//         opensteer_config config;
+//         opensteer_default_config (&config);
+//         opensteer_world* w = opensteer_create (&config);
+//         opensteer_add_agents (w, n, positions, NULL);
+//         each frame:
+//             opensteer_set_target (w, 0, playerX, playerZ);
+//             opensteer_step (w, 1, dt);
+//             opensteer_view (w, &view);   ...view.px[i]...
+//         opensteer_destroy (w);
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#ifndef OPENSTEER_OPENSTEERC_H
+#define OPENSTEER_OPENSTEERC_H
+
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+#if defined (_WIN32)
+#  ifdef OPENSTEER_C_BUILD
+#    define OPENSTEER_C_API __declspec (dllexport)
+#  else
+#    define OPENSTEER_C_API __declspec (dllimport)
+#  endif
+#else
+#  define OPENSTEER_C_API __attribute__ ((visibility ("default")))
+#endif
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    enum
+    {
+        OPENSTEER_OK = 0,
+        OPENSTEER_ERROR_ARGUMENT = -1,     // null pointer, bad index or value
+        OPENSTEER_ERROR_CAPACITY = -2,     // caller's buffer too small
+        OPENSTEER_ERROR_MEMORY = -3,
+        OPENSTEER_ERROR_INTERNAL = -4      // any other failure inside
+    };
+
+    typedef struct opensteer_world opensteer_world;
+
+    typedef struct opensteer_config
+    {
+        uint64_t seed;              // all random streams derive from it
+        int wanderers;              // quarries, the first at the origin
+        float wanderer_spread;      // radius the others are spaced on
+        float max_force;            // limits of added agents
+        float max_speed;
+        float spawn_inner;          // respawn ring around the target
+        float spawn_outer;
+        int threads;                // 0: every hardware thread
+    } opensteer_config;
+
+    // structure-of-arrays view of agent state, see above
+    typedef struct opensteer_soa_view
+    {
+        size_t count;
+        uint64_t frame;             // frames stepped since create
+        const float* px;
+        const float* py;
+        const float* pz;
+        const float* vx;
+        const float* vy;
+        const float* vz;
+    } opensteer_soa_view;
+
+    OPENSTEER_C_API void opensteer_default_config (opensteer_config* config);
+
+    // NULL on failure (also for a config with negative, NaN or infinite
+    // limits or spawn_inner beyond spawn_outer)
+    OPENSTEER_C_API opensteer_world* opensteer_create
+        (const opensteer_config* config);
+    OPENSTEER_C_API void opensteer_destroy (opensteer_world* world);
+
+    // add count agents at positions / with velocities (3 floats each),
+    // either may be NULL for a random spot on the spawn ring and rest.
+    // Any NaN or infinite value adds none.
+    OPENSTEER_C_API int opensteer_add_agents (opensteer_world* world,
+                                              size_t count,
+                                              const float* positions,
+                                              const float* velocities);
+
+    OPENSTEER_C_API size_t opensteer_agent_count
+        (const opensteer_world* world);
+
+    // move wanderer w (agents chase their nearest wanderer) to a finite
+    // (x, z)
+    OPENSTEER_C_API int opensteer_set_target (opensteer_world* world,
+                                              size_t w,
+                                              float x,
+                                              float z);
+
+    // advance frames fixed steps of dt seconds (finite, not negative)
+    OPENSTEER_C_API int opensteer_step (opensteer_world* world,
+                                        int frames,
+                                        float dt);
+
+    // copy every agent's state into out (3 floats each, room for
+    // capacity agents)
+    OPENSTEER_C_API int opensteer_get_positions (const opensteer_world* world,
+                                                 float* out,
+                                                 size_t capacity);
+    OPENSTEER_C_API int opensteer_get_velocities (const opensteer_world* world,
+                                                  float* out,
+                                                  size_t capacity);
+
+    // set the first count agents' state from in (3 floats each)
+    OPENSTEER_C_API int opensteer_set_positions (opensteer_world* world,
+                                                 const float* in,
+                                                 size_t count);
+    OPENSTEER_C_API int opensteer_set_velocities (opensteer_world* world,
+                                                  const float* in,
+                                                  size_t count);
+
+    OPENSTEER_C_API int opensteer_view (const opensteer_world* world,
+                                        opensteer_soa_view* view);
+
+#ifdef __cplusplus
+}
+#endif
+
+
+// ----------------------------------------------------------------------------
+#endif // OPENSTEER_OPENSTEERC_H
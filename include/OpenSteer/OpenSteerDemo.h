@@ -72,6 +72,42 @@ namespace OpenSteer {
     // run graphics event loop
     void run(void);
 
+    // configure agent populations, world and run length from a scenario
+    // file (see Scenario.h), call before OpenSteerDemo::initialize or replay
+    bool loadScenario (const char* path);
+
+    // step many independent copies of the scenario's world (seeds
+    // randomSeed () + i) across a pool of threads, without a window, and
+    // report throughput.  threads 0 uses every hardware thread.
+    void runBatch (const size_t worlds, const int threads);
+
+    // threads (including the main one) that run each frame's phases,
+    // optionally pinned to CPUs, call before OpenSteerDemo::initialize or
+    // replay.  threads 0 (the default) uses every hardware thread.
+    void setWorkerThreads (const int threads, const bool pin);
+
+    // stream every frame's vehicle states to a ring file (see Telemetry.h),
+    // raw or quantized, call before OpenSteerDemo::initialize or replay
+    void setTelemetryFile (const char* path, const bool quantized);
+
+    // publish every frame's vehicle states to a POSIX shared memory
+    // segment ("/name", see SharedState.h) for external viewers, call
+    // before OpenSteerDemo::initialize or replay
+    void setSharedStateName (const char* name);
+
+    // accept commands (move wanderers, spawn, despawn, region queries)
+    // from other processes on a Unix domain socket at path (see
+    // ControlServer.h), call before OpenSteerDemo::initialize or replay
+    void setControlSocket (const char* path);
+
+    // record the session's seed and input events to a file, written when
+    // run() exits (see InputLog.h)
+    void setInputRecordFile (const char* path);
+
+    // replay a recorded session headlessly at full speed (no window),
+    // returns false if the file cannot be read
+    bool replay (const char* path);
+
 } // namespace OpenSteer
 // ----------------------------------------------------------------------------
 #endif // OPENSTEER_OPENSTEERDEMO_H
@@ -0,0 +1,140 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// OrcaSolver: reciprocal collision avoidance (ORCA) for crowds of agents
+//
+// Optimal Reciprocal Collision Avoidance (van den Berg, Guy, Lin and
+// Manocha, "Reciprocal n-Body Collision Avoidance", 2011) on the XZ plane.
+// Each agent's neighbors (the nearest maxNeighbors within
+// neighborDistance, found with a SpatialGrid) each contribute a half plane
+// of velocities that avoid collision with it for timeHorizon seconds,
+// assuming the neighbor takes half the responsibility.  The agent's new
+// velocity is the one closest to its preferred velocity within all those
+// half planes and its speed limit: a small 2D linear program.  When the
+// half planes have no common point (dense crowds) the velocity that least
+// violates them is used instead.
+//
+// Unlike steerToAvoidNeighbors, which side-steps the single most imminent
+// threat, every neighbor is taken into account at once and agents agree
+// on how to pass each other, so dense crowds move smoothly at ordinary
+// time steps.
+//
+// solve () takes all agents as separate arrays, indexes them once, and
+// then solves the listed agents independently of each other, in parallel
+// when given a TaskScheduler.  Each solved agent has its own time step
+// (agents stepped at a coarser level of detail take longer ones).  The
+// result is a velocity per agent; to use it with applySteeringForce,
+// steer by (newVelocity - velocity) * mass / elapsedTime.
+// tools/AvoidanceBench.cpp measures the cost per frame.
+//
+// Usage:
+//         OrcaSolver::Options options;
+//         options.maxNeighbors = 10;
+//         OrcaSolver orca;
+//         orca.setOptions (options);
+//         OrcaSolver::Agents a = {n, positions, velocities, preferred,
+//                                 radii, maxSpeeds};
+//         orca.solve (a, 0, n, elapsedTimes, newVelocities, &scheduler);
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#ifndef OPENSTEER_ORCASOLVER_H
+#define OPENSTEER_ORCASOLVER_H
+
+
+#include "OpenSteer/SpatialGrid.h"
+#include "OpenSteer/TaskScheduler.h"
+#include "OpenSteer/Vec3.h"
+
+
+namespace OpenSteer {
+
+    class OrcaSolver
+    {
+    public:
+
+        struct Options
+        {
+            Options (void)
+                : neighborDistance (10),
+                  maxNeighbors (0),
+                  timeHorizon (2)
+            {}
+
+            float neighborDistance;     // neighbors considered within this
+            int maxNeighbors;           // at most this many, 0: no avoidance
+            float timeHorizon;          // seconds of guaranteed clearance
+        };
+
+        // every agent's state, each array count long (y is ignored)
+        struct Agents
+        {
+            size_t count;
+            const Vec3* position;
+            const Vec3* velocity;
+            const Vec3* preferred;      // velocity it would like to have
+            const float* radius;
+            const float* maxSpeed;
+        };
+
+        void setOptions (const Options& o) {options = o;}
+        const Options& getOptions (void) const {return options;}
+
+        // for k < activeCount, newVelocity[k] = the avoiding velocity of
+        // agent active[k] (of agent k if active is null) for a step of
+        // elapsedTime[k] seconds.  All agents are neighbors, active or not.
+        void solve (const Agents& agents,
+                    const size_t* active,
+                    const size_t activeCount,
+                    const float* elapsedTime,
+                    Vec3* newVelocity,
+                    TaskScheduler* scheduler);
+
+    private:
+
+        Vec3 solveAgent (const Agents& agents,
+                         const size_t i,
+                         const float elapsedTime) const;
+
+        Options options;
+        SpatialGrid grid;
+
+        // solve's scratch: each agent's position in the active list (or
+        // -1), and the active list in grid cell order
+        std::vector<int> slot;
+        std::vector<int> order;
+    };
+
+} // namespace OpenSteer
+
+
+// ----------------------------------------------------------------------------
+#endif // OPENSTEER_ORCASOLVER_H
@@ -0,0 +1,246 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// Profile: scoped timing zones for hot paths
+//
+// A zone is a named region of code timed by an RAII marker:
+//
+//         {
+//             OPENSTEER_PROFILE_ZONE ("steering");
+//             ...
+//         }
+//
+// Each thread appends completed zones (id, nesting depth, start and end
+// ticks) to its own fixed-size ring buffer, so recording takes no locks and
+// never allocates after the first zone on a thread.  Profiler::printReport
+// aggregates whatever is currently in the rings into a per-zone table of
+// min/mean/max and percentiles.  The report should be taken while other
+// threads are not recording (e.g. between frames).
+//
+// For timeline views, Profiler::captureTrace arms a capture of the next N
+// frames (frames are delimited by OPENSTEER_PROFILE_FRAME).  While armed,
+// every completed zone on every thread is also appended to a trace buffer
+// preallocated when the capture is requested, so capturing adds a few
+// atomic operations per zone and no allocation.  When the window closes,
+// and every thread still appending a zone has finished, the buffer is
+// written as Chrome trace-event JSON, viewable in chrome://tracing or
+// https://ui.perfetto.dev
+//
+// All of this is compiled only when OPENSTEER_PROFILE is defined (CMake
+// option OPENSTEER_PROFILE).  Otherwise the macros expand to nothing and
+// instrumented code is identical to uninstrumented code.
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#ifndef OPENSTEER_PROFILE_H
+#define OPENSTEER_PROFILE_H
+
+
+#ifdef OPENSTEER_PROFILE
+
+
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <string>
+
+
+namespace OpenSteer {
+
+    // one completed zone
+    struct ProfileSample
+    {
+        int64_t start;      // steady_clock nanoseconds
+        int64_t end;
+        uint16_t zone;      // index into the zone name registry
+        uint16_t depth;     // nesting depth on its thread (0 = outermost)
+        uint32_t thread;    // small per-process thread number
+    };
+
+
+    // per-thread ring buffer of completed zones
+    class ProfileRing
+    {
+    public:
+        static const int capacity = 1 << 16;
+
+        ProfileRing (const uint32_t threadNumber);
+
+        void push (const ProfileSample& s)
+        {
+            samples[head & (capacity - 1)] = s;
+            head++;
+        }
+
+        // number of valid samples currently held
+        int size (void) const {return head < capacity ? (int) head : capacity;}
+
+        // i-th oldest valid sample
+        const ProfileSample& at (const int i) const
+        {
+            return samples[(head - size () + i) & (capacity - 1)];
+        }
+
+        void clear (void) {head = 0;}
+
+        uint32_t thread;
+        uint16_t depth;
+    private:
+        uint64_t head;
+        ProfileSample samples[capacity];
+    };
+
+
+    class Profiler
+    {
+    public:
+        // map a zone name to a small integer id (done once per call site)
+        static int registerZone (const char* name);
+        static const char* zoneName (const int id);
+        static int zoneCount (void);
+
+        // the calling thread's ring (created on first use)
+        static ProfileRing& threadRing (void);
+
+        // visit every thread's ring (used by reports and exporters)
+        template <class Visitor> static void forEachRing (Visitor& v);
+
+        // print per-zone min/mean/max/p50/p99 over the samples in all rings
+        static void printReport (std::ostream& o);
+
+        // empty all rings
+        static void clear (void);
+
+        // arm a Chrome trace capture of the next "frames" frames, written to
+        // "path" when complete.  At most maxEvents zones are kept (later
+        // ones are counted as dropped).  Returns false if one is in progress.
+        static bool captureTrace (const int frames,
+                                  const std::string& path,
+                                  const int maxEvents = 1 << 20);
+
+        // called once at the start of each frame: opens and closes the
+        // capture window, writing the trace file when the window closes
+        static void frameMark (void);
+
+        // is a trace capture window currently open?
+        static bool tracing (void)
+        {
+            return traceActive.load (std::memory_order_relaxed);
+        }
+
+        // append a completed zone to the trace buffer (while tracing)
+        static void traceRecord (const ProfileSample& s);
+
+        static int64_t now (void)
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>
+                (std::chrono::steady_clock::now ().time_since_epoch ()).count ();
+        }
+
+    private:
+        static int ringCount (void);
+        static ProfileRing* ring (const int i);
+        static void writeTrace (void);
+        static std::atomic<bool> traceActive;
+    };
+
+
+    template <class Visitor>
+    void Profiler::forEachRing (Visitor& v)
+    {
+        const int n = ringCount ();
+        for (int i = 0; i < n; i++) v (*ring (i));
+    }
+
+
+    // RAII zone marker: records [construction, destruction) into the ring
+    class ProfileZone
+    {
+    public:
+        ProfileZone (const int zone)
+            : _ring (Profiler::threadRing ())
+        {
+            _sample.zone = (uint16_t) zone;
+            _sample.depth = _ring.depth++;
+            _sample.thread = _ring.thread;
+            _sample.start = Profiler::now ();
+        }
+
+        ~ProfileZone ()
+        {
+            _sample.end = Profiler::now ();
+            _ring.depth--;
+            _ring.push (_sample);
+            if (Profiler::tracing ()) Profiler::traceRecord (_sample);
+        }
+
+    private:
+        ProfileRing& _ring;
+        ProfileSample _sample;
+    };
+
+} // namespace OpenSteer
+
+
+#define OPENSTEER_PROFILE_CONCAT2(a, b) a##b
+#define OPENSTEER_PROFILE_CONCAT(a, b) OPENSTEER_PROFILE_CONCAT2 (a, b)
+
+#define OPENSTEER_PROFILE_ZONE(name)                                         \
+    static const int OPENSTEER_PROFILE_CONCAT (profileZoneId_, __LINE__) =  \
+        OpenSteer::Profiler::registerZone (name);                           \
+    OpenSteer::ProfileZone OPENSTEER_PROFILE_CONCAT (profileZone_, __LINE__) \
+        (OPENSTEER_PROFILE_CONCAT (profileZoneId_, __LINE__))
+
+#define OPENSTEER_PROFILE_REPORT(stream) \
+    OpenSteer::Profiler::printReport (stream)
+
+#define OPENSTEER_PROFILE_FRAME() \
+    OpenSteer::Profiler::frameMark ()
+
+#define OPENSTEER_PROFILE_CAPTURE_TRACE(frames, path) \
+    OpenSteer::Profiler::captureTrace (frames, path)
+
+
+#else // OPENSTEER_PROFILE
+
+
+#define OPENSTEER_PROFILE_ZONE(name)
+#define OPENSTEER_PROFILE_REPORT(stream)
+#define OPENSTEER_PROFILE_FRAME()
+#define OPENSTEER_PROFILE_CAPTURE_TRACE(frames, path)
+
+
+#endif // OPENSTEER_PROFILE
+
+
+// ----------------------------------------------------------------------------
+#endif // OPENSTEER_PROFILE_H
@@ -0,0 +1,134 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// Random: seedable, fast pseudo-random number streams
+//
+// RandomStream is xoshiro256** (Blackman and Vigna): 256 bits of state, a
+// handful of shifts/xors per number, no locks.  A stream is identified by a
+// (seed, stream number) pair, the state being derived from both with
+// splitmix64, so e.g. one stream per agent gives independent sequences
+// which do not depend on the order agents (or threads) draw from them.
+//
+// Each vehicle owns a stream (SteerLibraryMixin::randomStream) used by its
+// randomized steering.  The global functions frandom01, RandomUnitVector
+// etc. draw from a per-thread stream; setRandomSeed changes the seed all
+// streams derive from (per-thread streams reseed on their next use).
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#ifndef OPENSTEER_RANDOM_H
+#define OPENSTEER_RANDOM_H
+
+
+#include <stdint.h>
+
+
+namespace OpenSteer {
+
+    class RandomStream
+    {
+    public:
+
+        // complete generator state (for snapshots)
+        struct State
+        {
+            uint64_t s[4];
+        };
+
+        RandomStream (const uint64_t seed = 0, const uint64_t stream = 0)
+        {
+            setSeed (seed, stream);
+        }
+
+        // restart as the given (seed, stream) sequence
+        void setSeed (const uint64_t seed, const uint64_t stream)
+        {
+            uint64_t x = seed ^ mix (stream);
+            for (int i = 0; i < 4; i++) _state.s[i] = splitmix64 (x);
+        }
+
+        // next 64 random bits
+        uint64_t next (void)
+        {
+            uint64_t* s = _state.s;
+            const uint64_t result = rotl (s[1] * 5, 7) * 9;
+            const uint64_t t = s[1] << 17;
+            s[2] ^= s[0];
+            s[3] ^= s[1];
+            s[1] ^= s[2];
+            s[0] ^= s[3];
+            s[2] ^= t;
+            s[3] = rotl (s[3], 45);
+            return result;
+        }
+
+        // float uniformly distributed in [0, 1)
+        float next01 (void)
+        {
+            return (next () >> 40) * (1.0f / 16777216.0f);
+        }
+
+        const State& state (void) const {return _state;}
+        void setState (const State& s) {_state = s;}
+
+    private:
+
+        static uint64_t rotl (const uint64_t x, const int k)
+        {
+            return (x << k) | (x >> (64 - k));
+        }
+
+        // advances x, returns a well mixed function of it
+        static uint64_t splitmix64 (uint64_t& x)
+        {
+            uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            return z ^ (z >> 31);
+        }
+        static uint64_t mix (uint64_t x) {return splitmix64 (x);}
+
+        State _state;
+    };
+
+
+    // the seed all streams derive from (default 0)
+    uint64_t randomSeed (void);
+    void setRandomSeed (const uint64_t seed);
+
+    // the calling thread's stream, used by the global random utilities
+    RandomStream& threadRandomStream (void);
+
+} // namespace OpenSteer
+
+
+// ----------------------------------------------------------------------------
+#endif // OPENSTEER_RANDOM_H
@@ -0,0 +1,133 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// Scenario: run configuration loaded from a text file
+//
+// Describes the world (size, drawing scale, time step, run length, seed)
+// and one or more pursuer populations, each with its own count, steering
+// limits and spawn ring.  The file is a list of "key value" lines; blank
+// lines and text after '#' are ignored.  A "population <name>" line starts
+// a new population, the population keys that follow apply to it:
+//
+//         world_size    1000     # window size in pixels
+//         multi         20       # pixels per world unit
+//         elapsed_time  0.006    # fixed simulation time step (seconds)
+//         frames        0        # frames to run, 0 runs until ESC
+//         seed          42       # random seed (see Random.h)
+//         wanderers     1        # quarries: the player's at the origin,
+//         wanderer_spread 40     # others on a circle of this radius
+//         reassign_frames 8      # steps to re-target every pursuer once
+//         lod_tier      15 1     # level of detail tiers (LodScheduler.h):
+//         lod_tier      40 4     # max distance to the wanderer, period
+//         sleep_frames  30       # sleep after 30 quiet steps (Activity.h),
+//         sleep_force   0.01     # quiet: steering force and speed below
+//         sleep_speed   0.01     # these, woken when the wanderer comes
+//         wake_radius   10       # within wake_radius
+//         avoid_neighbors 10     # ORCA avoidance between pursuers
+//         avoid_distance  10     # (OrcaSolver.h): neighbors considered,
+//         avoid_horizon   2      # within what distance, seconds ahead
+//
+//         population pursuers
+//         count         8
+//         max_force     5
+//         max_speed     3
+//         spawn_inner   20       # spawn ring radii around the wanderer
+//         spawn_outer   30
+//
+// Values out of range (a negative count, a time step or avoid_horizon
+// that is not positive, spawn_inner beyond spawn_outer, lod_tier
+// distances not increasing, ...) are rejected like unreadable ones.
+//
+// A default constructed Scenario has the demo's original settings: one
+// population of 8 pursuers.
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#ifndef OPENSTEER_SCENARIO_H
+#define OPENSTEER_SCENARIO_H
+
+
+#include "OpenSteer/LodScheduler.h"
+#include "OpenSteer/Activity.h"
+#include "OpenSteer/OrcaSolver.h"
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+
+namespace OpenSteer {
+
+    class Scenario
+    {
+    public:
+
+        struct Population
+        {
+            Population (void);
+
+            std::string name;
+            int count;
+            float maxForce;
+            float maxSpeed;
+            float spawnInner;
+            float spawnOuter;
+        };
+
+        Scenario (void);
+
+        // replace this scenario with the contents of a file, returns false
+        // (with a message on std::cerr) on failure
+        bool load (const std::string& path);
+
+        // total number of pursuers over all populations
+        int pursuerCount (void) const;
+
+        int worldSize;
+        float multi;
+        float elapsedTime;
+        uint32_t frames;
+        bool hasSeed;
+        uint64_t seed;
+        int wanderers;
+        float wandererSpread;
+        int reassignFrames;
+        std::vector<LodScheduler::Tier> lodTiers;   // empty: no LOD
+        Activity::Thresholds sleep;                 // frames 0: no sleep
+        OrcaSolver::Options avoidance;              // neighbors 0: none
+        std::vector<Population> populations;
+    };
+
+} // namespace OpenSteer
+
+
+// ----------------------------------------------------------------------------
+#endif // OPENSTEER_SCENARIO_H
@@ -0,0 +1,182 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// SharedState: agent arrays published in POSIX shared memory for viewers
+//
+// The simulation publishes each frame's agent states (id, position,
+// heading, speed; as separate arrays) into a named shared memory segment,
+// and any number of processes on the same machine map it read-only and
+// use the arrays in place: no copies, sockets or serialization.
+//
+// The segment holds two buffers.  The writer always fills the one not most
+// recently published, then flips "latest" to it, so a reader of the latest
+// frame is undisturbed unless it takes longer than a whole frame.  Each
+// buffer has a sequence number (a seqlock): odd while the buffer is being
+// written.  A reader notes the sequence before using a buffer and checks
+// it is unchanged afterwards; if it changed the frame was overwritten
+// meanwhile and the reader retries.  The writer never waits for readers.
+//
+// Usage (writer, the simulation):
+//         SharedStateWriter share;
+//         share.open ("/opensteer", capacity);
+//         each frame:
+//             SharedState::View v = share.beginWrite (frame, time);
+//             for (i < n) v.x[i] = ...;
+//             share.endWrite (v, n);
+//
+// Usage (reader, another process):
+//         SharedStateReader share;
+//         share.open ("/opensteer");
+//         SharedState::View v;
+//         uint64_t token = 0;
+//         for (;;) {
+//             if (! share.beginRead (v, token)) continue;
+//             ... v.x[i] for i < v.count ...
+//             if (share.endRead (token)) break;
+//         }
+//
+// POSIX only (shm_open, mmap).  See tools/SharedStateView.cpp for a small
+// reader.
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#ifndef OPENSTEER_SHAREDSTATE_H
+#define OPENSTEER_SHAREDSTATE_H
+
+
+#include "OpenSteer/StandardTypes.h"
+
+#include <stdint.h>
+#include <string>
+
+
+namespace OpenSteer {
+
+    namespace SharedState {
+
+        // current segment layout version
+        const uint32_t version = 1;
+
+        // one buffer's frame: arrays of count agents (heading is yaw about
+        // +Y, radians, 0 along +Z).  Const for readers in spirit: readers
+        // map the segment read-only.
+        struct View
+        {
+            uint64_t frame;
+            double time;
+            uint32_t count;
+            uint32_t capacity;
+            uint32_t* id;
+            float* x;
+            float* y;
+            float* z;
+            float* heading;
+            float* speed;
+        };
+
+        // bytes of a segment holding capacity agents per buffer
+        size_t segmentBytes (const uint32_t capacity);
+
+    } // namespace SharedState
+
+
+    class SharedStateWriter
+    {
+    public:
+
+        SharedStateWriter (void);
+        ~SharedStateWriter (void);
+
+        // create (or replace) the named segment ("/name") sized for
+        // capacity agents, returns false (with a message on std::cerr) on
+        // failure
+        bool open (const std::string& name, const uint32_t capacity);
+
+        // unmap and remove the segment
+        void close (void);
+
+        bool isOpen (void) const {return segment != 0;}
+        uint32_t capacity (void) const {return agentCapacity;}
+
+        // the arrays of the buffer to fill for this frame, then publish
+        // its first count (at most capacity) agents
+        SharedState::View beginWrite (const uint64_t frame, const double time);
+        void endWrite (const SharedState::View& v, const uint32_t count);
+
+    private:
+
+        std::string segmentName;
+        unsigned char* segment;
+        size_t bytes;
+        uint32_t agentCapacity;
+        int writing;
+
+        // not copyable
+        SharedStateWriter (const SharedStateWriter&);
+        SharedStateWriter& operator= (const SharedStateWriter&);
+    };
+
+
+    class SharedStateReader
+    {
+    public:
+
+        SharedStateReader (void);
+        ~SharedStateReader (void);
+
+        // map an existing segment read-only, returns false (with a message
+        // on std::cerr) if it does not exist or is not a SharedState
+        bool open (const std::string& name);
+        void close (void);
+
+        // start using the latest frame in place: false if it is being
+        // written right now (try again)
+        bool beginRead (SharedState::View& v, uint64_t& token) const;
+
+        // true if the frame was not overwritten since its beginRead, so
+        // everything read from it is consistent
+        bool endRead (const uint64_t token) const;
+
+    private:
+
+        const unsigned char* segment;
+        size_t bytes;
+
+        // not copyable
+        SharedStateReader (const SharedStateReader&);
+        SharedStateReader& operator= (const SharedStateReader&);
+    };
+
+} // namespace OpenSteer
+
+
+// ----------------------------------------------------------------------------
+#endif // OPENSTEER_SHAREDSTATE_H
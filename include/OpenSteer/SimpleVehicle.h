@@ -68,6 +68,8 @@
 #include "OpenSteer/SteerLibrary.h"
 #include "OpenSteer/Annotation.h"
 
+#include <atomic>
+
 
 namespace OpenSteer {
 
@@ -79,8 +81,14 @@ namespace OpenSteer {
     typedef LocalSpaceMixin<AbstractVehicle> SimpleVehicle_1;
 
 
+#ifndef OPENSTEER_NO_ANNOTATION
     // SimpleVehicle_2 adds concrete annotation methods to SimpleVehicle_1
     typedef AnnotationMixin<SimpleVehicle_1> SimpleVehicle_2;
+#else
+    // SimpleVehicle_2 adds no-op annotation methods to SimpleVehicle_1
+    // (annotation is compiled out, see SteerLibrary.h)
+    typedef NullAnnotationMixin<SimpleVehicle_1> SimpleVehicle_2;
+#endif
 
 
     // SimpleVehicle_3 adds concrete steering methods to SimpleVehicle_2
@@ -201,9 +209,41 @@ namespace OpenSteer {
             return _smoothedPosition = value;
         }
 
-        // give each vehicle a unique number
+        // complete dynamic state of a SimpleVehicle as plain data: local
+        // space basis, physical parameters, smoothing registers, wander
+        // state and random stream.  Used to snapshot and restore vehicles
+        // in bulk (see Snapshot.h).  Annotation (trail) state is not saved.
+        struct State
+        {
+            Vec3 side;
+            Vec3 up;
+            Vec3 forward;
+            Vec3 position;
+            float mass;
+            float radius;
+            float speed;
+            float maxForce;
+            float maxSpeed;
+            float curvature;
+            Vec3 lastForward;
+            Vec3 lastPosition;
+            Vec3 smoothedPosition;
+            float smoothedCurvature;
+            Vec3 smoothedAcceleration;
+            float wanderSide;
+            float wanderUp;
+            RandomStream::State random;
+        };
+        void getState (State& s) const;
+        void setState (const State& s);
+
+        // constructor: directly in a saved state, without reset ()
+        explicit SimpleVehicle (const State& s);
+
+        // give each vehicle a unique number (MpWorld renumbers its own
+        // vehicles 0, 1, ... so ids do not depend on other worlds)
         int serialNumber;
-        static int serialNumberCounter;
+        static std::atomic<int> serialNumberCounter;
 
 //        // draw lines from vehicle's position showing its velocity and acceleration
 //        void annotationVelocityAcceleration (float maxLengthA, float maxLengthV);
@@ -217,7 +257,7 @@ namespace OpenSteer {
         void randomizeHeadingOnXZPlane (void)
         {
             setUp (Vec3::up);
-            setForward (RandomUnitVectorOnXZPlane ());
+            setForward (RandomUnitVectorOnXZPlane (randomStream ()));
             setSide (localRotateForwardToSide (forward()));
         }
 
@@ -0,0 +1,114 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// Snapshot: versioned binary checkpoint of a group of SimpleVehicles
+//
+// A snapshot file is a fixed header followed by one contiguous array of
+// SimpleVehicle::State records (the wanderers' first, then the pursuers')
+// and one of Role records (one per pursuer: what it chases, its population
+// and its sleep state), each written and read with a single bulk I/O call,
+// so saving or restoring even very large worlds is bounded by disk
+// bandwidth.  Records are in native byte order and layout; the header
+// stores the record sizes so a file written by an incompatible build is
+// rejected rather than misread.
+//
+// Usage:
+//         std::vector<SimpleVehicle::State> states (vehicles.size ());
+//         for (i...) vehicles[i]->getState (states[i]);
+//         std::vector<Snapshot::Role> roles (pursuers.size ());
+//         ...
+//         info.wandererCount = wanderers.size ();
+//         Snapshot::write ("world.snapshot", info, states, roles);
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#ifndef OPENSTEER_SNAPSHOT_H
+#define OPENSTEER_SNAPSHOT_H
+
+
+#include "OpenSteer/SimpleVehicle.h"
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+
+namespace OpenSteer {
+
+    class Snapshot
+    {
+    public:
+
+        // current file format version
+        static const uint32_t version = 2;
+
+        // world level information stored alongside the vehicle records
+        struct Info
+        {
+            uint64_t randomSeed;      // global seed (see Random.h)
+            uint64_t frame;           // frame number when taken
+            double simulationTime;    // simulation time when taken
+            uint64_t vehicleCount;    // number of State records
+            uint64_t wandererCount;   // of which wanderers (the first)
+            uint64_t populationCount; // populations of the world
+        };
+
+        // a pursuer's part in the world, beyond its vehicle state
+        struct Role
+        {
+            uint32_t target;          // index of the wanderer it chases
+            uint32_t population;      // index into the world's populations
+            int32_t quietSteps;       // Activity
+            uint32_t asleep;
+        };
+
+        // write info, states and one role per pursuer (info.vehicleCount
+        // is set from states, states.size () must be info.wandererCount
+        // plus roles.size ()), returns false (with a message on
+        // std::cerr) on failure
+        static bool write (const std::string& path,
+                           Info info,
+                           const std::vector<SimpleVehicle::State>& states,
+                           const std::vector<Role>& roles);
+
+        // read a snapshot, replacing the contents of info, states and
+        // roles, returns false (with a message on std::cerr) on failure
+        static bool read (const std::string& path,
+                          Info& info,
+                          std::vector<SimpleVehicle::State>& states,
+                          std::vector<Role>& roles);
+    };
+
+} // namespace OpenSteer
+
+
+// ----------------------------------------------------------------------------
+#endif // OPENSTEER_SNAPSHOT_H
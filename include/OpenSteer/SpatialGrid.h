@@ -0,0 +1,122 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// SpatialGrid: uniform grid index over points on the XZ plane
+//
+// rebuild () bins a set of points into square cells covering their bounds
+// with a counting sort: two linear passes, no per-point allocation, and
+// the points of each cell (and their positions) end up contiguous.
+// Queries then visit only the cells near the query point.  The grid is
+// meant to be rebuilt whenever the points have moved (say each frame); the
+// index of a point is its position in the array given to rebuild.
+//
+// Usage:
+//         grid.rebuild (&positions[0], positions.size (), 10);
+//         const int i = grid.nearest (p);
+//         grid.queryRadius (p, 5, neighbors);
+//         grid.queryNearest (p, 10, 5, nearest);
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#ifndef OPENSTEER_SPATIALGRID_H
+#define OPENSTEER_SPATIALGRID_H
+
+
+#include "OpenSteer/Vec3.h"
+#include "OpenSteer/StandardTypes.h"
+
+#include <utility>
+#include <vector>
+
+
+namespace OpenSteer {
+
+    class SpatialGrid
+    {
+    public:
+
+        SpatialGrid (void);
+
+        // index count points (their x and z) in cells of about cellSize
+        // (cells grow if needed to keep the grid to O(count) cells)
+        void rebuild (const Vec3* points,
+                      const size_t count,
+                      const float cellSize);
+
+        // index of the point nearest to p, or -1 if there are none
+        int nearest (const Vec3& p) const;
+
+        // append the indices of all points within radius of p to result
+        void queryRadius (const Vec3& p,
+                          const float radius,
+                          std::vector<int>& result) const;
+
+        // the (at most) k points nearest to p within radius, as (distance
+        // squared, index) pairs, nearest first.  Visits rings of cells
+        // outward from p only until no nearer point can remain.
+        void queryNearest (const Vec3& p,
+                           const size_t k,
+                           const float radius,
+                           std::vector<std::pair<float, int> >& result) const;
+
+        size_t pointCount (void) const {return positions.size () / 2;}
+
+        // every point index, cell by cell (so points near each other in
+        // space are mostly near each other in this order)
+        const std::vector<int>& cellOrder (void) const {return cellPoints;}
+
+    private:
+
+        // cell coordinates of a position, clamped to the grid
+        int column (const float x) const;
+        int row (const float z) const;
+
+        float cellSize;
+        float minX, minZ;
+        int columns, rows;
+
+        // cellStart[c] .. cellStart[c+1] index cellPoints for cell c
+        std::vector<int> cellStart;
+        std::vector<int> cellPoints;
+
+        // x and z of each point, interleaved, in the order of cellPoints
+        // (so a cell's positions are contiguous)
+        std::vector<float> positions;
+
+        // rebuild's fill cursor per cell
+        std::vector<int> fill;
+    };
+
+} // namespace OpenSteer
+
+
+// ----------------------------------------------------------------------------
+#endif // OPENSTEER_SPATIALGRID_H
@@ -0,0 +1,115 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// SpscQueue: bounded lock-free queue for one producer and one consumer
+//
+// A ring of a power of two slots with a head (advanced only by the
+// consumer) and a tail (advanced only by the producer), each on its own
+// cache line.  push and pop never block or allocate: push fails when the
+// queue is full, pop when it is empty.  Used to hand work from a service
+// thread to the simulation thread, which drains it at step boundaries.
+//
+// Usage:
+//         SpscQueue<Command> queue (4096);
+//         producer thread:  if (! queue.push (c)) ...full, reject...
+//         consumer thread:  while (queue.pop (c)) apply (c);
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#ifndef OPENSTEER_SPSCQUEUE_H
+#define OPENSTEER_SPSCQUEUE_H
+
+
+#include "OpenSteer/StandardTypes.h"
+
+#include <atomic>
+#include <vector>
+
+
+namespace OpenSteer {
+
+    template <class T>
+    class SpscQueue
+    {
+    public:
+
+        // room for at least capacity items (rounded up to a power of two)
+        explicit SpscQueue (const size_t capacity)
+            : head (0),
+              tail (0)
+        {
+            size_t n = 2;
+            while (n < capacity) n *= 2;
+            slots.resize (n);
+            mask = n - 1;
+        }
+
+        // producer: false if full
+        bool push (const T& item)
+        {
+            const size_t t = tail.load (std::memory_order_relaxed);
+            if (t - head.load (std::memory_order_acquire) > mask) return false;
+            slots[t & mask] = item;
+            tail.store (t + 1, std::memory_order_release);
+            return true;
+        }
+
+        // consumer: false if empty
+        bool pop (T& item)
+        {
+            const size_t h = head.load (std::memory_order_relaxed);
+            if (h == tail.load (std::memory_order_acquire)) return false;
+            item = slots[h & mask];
+            head.store (h + 1, std::memory_order_release);
+            return true;
+        }
+
+        size_t capacity (void) const {return mask + 1;}
+
+    private:
+
+        std::vector<T> slots;
+        size_t mask;
+
+        // consumer and producer positions, on separate cache lines
+        alignas (64) std::atomic<size_t> head;
+        alignas (64) std::atomic<size_t> tail;
+
+        // not copyable
+        SpscQueue (const SpscQueue&);
+        SpscQueue& operator= (const SpscQueue&);
+    };
+
+} // namespace OpenSteer
+
+
+// ----------------------------------------------------------------------------
+#endif // OPENSTEER_SPSCQUEUE_H
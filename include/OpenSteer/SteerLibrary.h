@@ -51,10 +51,58 @@
 #include "OpenSteer/Pathway.h"
 #include "OpenSteer/Obstacle.h"
 #include "OpenSteer/Utilities.h"
+#include "OpenSteer/Metrics.h"
+
+
+// ----------------------------------------------------------------------------
+// Graphical annotation can be stripped at compile time for production builds
+// by defining OPENSTEER_NO_ANNOTATION (CMake option of the same name).  The
+// annotate* hooks, the calls to them and the state kept only for them are
+// then removed from SteerLibraryMixin, and SimpleVehicle is built on
+// NullAnnotationMixin (see Annotation.h) instead of AnnotationMixin.
+
+
+#ifdef OPENSTEER_NO_ANNOTATION
+#define OPENSTEER_ANNOTATE(call) ((void) 0)
+#else
+#define OPENSTEER_ANNOTATE(call) call
+#endif
 
 
 namespace OpenSteer {
 
+    // ----------------------------------------------------------------------------
+    // the state of a pursuit quarry, captured once (say per frame) so that
+    // many pursuers of the same quarry need not each query it through
+    // virtual calls.  Its future position is predicted linearly, as by
+    // SimpleVehicle::predictFuturePosition.
+
+
+    struct QuarryState
+    {
+        QuarryState (void) : speed (0), radius (0) {}
+
+        explicit QuarryState (const AbstractVehicle& quarry)
+            : position (quarry.position ()),
+              velocity (quarry.velocity ()),
+              forward (quarry.forward ()),
+              speed (quarry.speed ()),
+              radius (quarry.radius ())
+        {}
+
+        Vec3 predictFuturePosition (const float predictionTime) const
+        {
+            return position + (velocity * predictionTime);
+        }
+
+        Vec3 position;
+        Vec3 velocity;
+        Vec3 forward;
+        float speed;
+        float radius;
+    };
+
+
     // ----------------------------------------------------------------------------
 
 
@@ -76,7 +124,7 @@ namespace OpenSteer {
     public:
 
         // Constructor: initializes state
-        SteerLibraryMixin ()
+        SteerLibraryMixin () : _publishMetrics (true)
         {
             // set inital state
             reset ();
@@ -90,7 +138,7 @@ namespace OpenSteer {
             WanderUp = 0;
 
             // default to non-gaudyPursuitAnnotation
-            gaudyPursuitAnnotation = false;
+            OPENSTEER_ANNOTATE (gaudyPursuitAnnotation = false);
         }
 
         // -------------------------------------------------- steering behaviors
@@ -100,6 +148,22 @@ namespace OpenSteer {
         float WanderUp;
         Vec3 steerForWander (float dt);
 
+        // this vehicle's own random number stream, used by randomized
+        // behaviors (wander) so results do not depend on the order in which
+        // vehicles or threads draw random numbers.  Not changed by reset.
+        RandomStream& randomStream (void) {return _randomStream;}
+        const RandomStream& randomStream (void) const {return _randomStream;}
+
+        // whether steering behaviors count their proximity tests in the
+        // global standard Metrics (default true, not changed by reset).
+        // MpWorld clears it on its vehicles when it does not publish.
+        void setPublishMetrics (const bool p) {_publishMetrics = p;}
+        bool publishMetrics (void) const {return _publishMetrics;}
+    private:
+        RandomStream _randomStream;
+        bool _publishMetrics;
+    public:
+
         // Seek behavior
         Vec3 steerForSeek (const Vec3& target);
 
@@ -160,10 +224,19 @@ namespace OpenSteer {
         float computeNearestApproachPositions (AbstractVehicle& otherVehicle,
                                                float time);
 
+        // same, returning both positions through output arguments rather
+        // than the annotation members below
+        float computeNearestApproachPositions (AbstractVehicle& otherVehicle,
+                                               float time,
+                                               Vec3& ourPosition,
+                                               Vec3& hisPosition) const;
 
+
+#ifndef OPENSTEER_NO_ANNOTATION
         /// XXX globals only for the sake of graphical annotation
         Vec3 hisPositionAtNearestApproach;
         Vec3 ourPositionAtNearestApproach;
+#endif
 
 
         // ------------------------------------------------------------------------
@@ -223,8 +296,20 @@ namespace OpenSteer {
         Vec3 steerForPursuit (const AbstractVehicle& quarry,
                               const float maxPredictionTime);
 
+        // same, for a quarry whose state was captured beforehand
+        Vec3 steerForPursuit (const QuarryState& quarry,
+                              const float maxPredictionTime);
+
+        // estimated time until intercept of a quarry at quarryPosition
+        // heading along quarryForward, limited to maxPredictionTime
+        float pursuitPredictionTime (const Vec3& quarryPosition,
+                                     const Vec3& quarryForward,
+                                     const float maxPredictionTime) const;
+
+#ifndef OPENSTEER_NO_ANNOTATION
         // for annotation
         bool gaudyPursuitAnnotation;
+#endif
 
 
         // ------------------------------------------------------------------------
@@ -271,6 +356,7 @@ namespace OpenSteer {
         };
 
 
+#ifndef OPENSTEER_NO_ANNOTATION
         // ------------------------------------------------ graphical annotation
         // (parameter names commented out to prevent compiler warning from "-W")
 
@@ -305,6 +391,7 @@ namespace OpenSteer {
                                             const Vec3& /*threatFuture*/)
         {
         }
+#endif // OPENSTEER_NO_ANNOTATION
     };
 
     
@@ -320,8 +407,8 @@ steerForWander (float dt)
 {
     // random walk WanderSide and WanderUp between -1 and +1
     const float speed = 12.0f * dt; // maybe this (12) should be an argument?
-    WanderSide = scalarRandomWalk (WanderSide, speed, -1, +1);
-    WanderUp   = scalarRandomWalk (WanderUp,   speed, -1, +1);
+    WanderSide = scalarRandomWalk (WanderSide, speed, -1, +1, _randomStream);
+    WanderUp   = scalarRandomWalk (WanderUp,   speed, -1, +1, _randomStream);
 
     // return a pure lateral steering vector: (+/-Side) + (+/-Up)
     return (side() * WanderSide) + (up() * WanderUp);
@@ -414,7 +501,8 @@ steerToStayOnPath (const float predictionTime, Pathway& path)
         // our predicted future position was outside the path, need to
         // steer towards it.  Use onPath projection of futurePosition
         // as seek target
-        annotatePathFollowing (futurePosition, onPath, onPath, outside);
+        OPENSTEER_ANNOTATE (annotatePathFollowing (futurePosition, onPath,
+                                                   onPath, outside));
         return steerForSeek (onPath);
     }
 }
@@ -470,7 +558,8 @@ steerToFollowPath (const int direction,
         float const targetPathDistance = nowPathDistance + pathDistanceOffset;
         Vec3 const target = path.mapPathDistanceToPoint (targetPathDistance);
 
-        annotatePathFollowing (futurePosition, onPath, target, outside);
+        OPENSTEER_ANNOTATE (annotatePathFollowing (futurePosition, onPath,
+                                                   target, outside));
 
         // return steering to seek target on path
         return steerForSeek (target);
@@ -506,10 +595,12 @@ steerToAvoidObstacle (const float minTimeToCollision,
                       const Obstacle& obstacle)
 {
     const Vec3 avoidance = obstacle.steerToAvoid (*this, minTimeToCollision);
+    if (_publishMetrics)
+        Metrics::standard().obstacleTests.increment ();
 
     // XXX more annotation modularity problems (assumes spherical obstacle)
     if (avoidance != Vec3::zero)
-        annotateAvoidObstacle (minTimeToCollision * speed());
+        OPENSTEER_ANNOTATE (annotateAvoidObstacle (minTimeToCollision * speed()));
 
     return avoidance;
 }
@@ -526,10 +617,12 @@ steerToAvoidObstacles (const float minTimeToCollision,
     const Vec3 avoidance = Obstacle::steerToAvoidObstacles (*this,
                                                             minTimeToCollision,
                                                             obstacles);
+    if (_publishMetrics)
+        Metrics::standard().obstacleTests.add (obstacles.size ());
 
     // XXX more annotation modularity problems (assumes spherical obstacle)
     if (avoidance != Vec3::zero)
-        annotateAvoidObstacle (minTimeToCollision * speed());
+        OPENSTEER_ANNOTATE (annotateAvoidObstacle (minTimeToCollision * speed()));
 
     return avoidance;
 }
@@ -562,9 +655,9 @@ steerToAvoidNeighbors (const float minTimeToCollision,
     // many frames into the future.
     float minTime = minTimeToCollision;
 
-    // xxx solely for annotation
+    // future position of the threat (and, solely for annotation, of us)
     Vec3 xxxThreatPositionAtNearestApproach;
-    Vec3 xxxOurPositionAtNearestApproach;
+    OPENSTEER_ANNOTATE (Vec3 xxxOurPositionAtNearestApproach);
 
     // for each of the other vehicles, determine which (if any)
     // pose the most immediate threat of collision.
@@ -585,19 +678,22 @@ steerToAvoidNeighbors (const float minTimeToCollision,
             {
                 // if the two will be close enough to collide,
                 // make a note of it
-                if (computeNearestApproachPositions (other, time)
+                Vec3 ourFuture, hisFuture;
+                if (computeNearestApproachPositions (other, time,
+                                                     ourFuture, hisFuture)
                     < collisionDangerThreshold)
                 {
                     minTime = time;
                     threat = &other;
-                    xxxThreatPositionAtNearestApproach
-                        = hisPositionAtNearestApproach;
-                    xxxOurPositionAtNearestApproach
-                        = ourPositionAtNearestApproach;
+                    xxxThreatPositionAtNearestApproach = hisFuture;
+                    OPENSTEER_ANNOTATE (xxxOurPositionAtNearestApproach
+                                        = ourFuture);
                 }
             }
         }
     }
+    if (_publishMetrics)
+        Metrics::standard().neighborQueries.add (others.size ());
 
     // if a potential collision was found, compute steering to avoid
     if (threat != NULL)
@@ -635,10 +731,10 @@ steerToAvoidNeighbors (const float minTimeToCollision,
             }
         }
 
-        annotateAvoidNeighbor (*threat,
-                               steer,
-                               xxxOurPositionAtNearestApproach,
-                               xxxThreatPositionAtNearestApproach);
+        OPENSTEER_ANNOTATE (annotateAvoidNeighbor (*threat,
+                                                   steer,
+                                                   xxxOurPositionAtNearestApproach,
+                                                   xxxThreatPositionAtNearestApproach));
     }
 
     return side() * steer;
@@ -694,16 +790,34 @@ float
 OpenSteer::SteerLibraryMixin<Super>::
 computeNearestApproachPositions (AbstractVehicle& otherVehicle,
                                  float time)
+{
+    Vec3 myFinal, otherFinal;
+    const float distance = computeNearestApproachPositions (otherVehicle,
+                                                            time,
+                                                            myFinal,
+                                                            otherFinal);
+
+    // xxx for annotation
+    OPENSTEER_ANNOTATE (ourPositionAtNearestApproach = myFinal);
+    OPENSTEER_ANNOTATE (hisPositionAtNearestApproach = otherFinal);
+
+    return distance;
+}
+
+
+template<class Super>
+float
+OpenSteer::SteerLibraryMixin<Super>::
+computeNearestApproachPositions (AbstractVehicle& otherVehicle,
+                                 float time,
+                                 Vec3& myFinal,
+                                 Vec3& otherFinal) const
 {
     const Vec3    myTravel =       forward () *       speed () * time;
     const Vec3 otherTravel = otherVehicle.forward () * otherVehicle.speed () * time;
 
-    const Vec3    myFinal =       position () +    myTravel;
-    const Vec3 otherFinal = otherVehicle.position () + otherTravel;
-
-    // xxx for annotation
-    ourPositionAtNearestApproach = myFinal;
-    hisPositionAtNearestApproach = otherFinal;
+    myFinal = position () + myTravel;
+    otherFinal = otherVehicle.position () + otherTravel;
 
     return Vec3::distance (myFinal, otherFinal);
 }
@@ -737,13 +851,18 @@ steerToAvoidCloseNeighbors (const float minSeparationDistance,
 
             if (currentDistance < minCenterToCenter)
             {
-                annotateAvoidCloseNeighbor (other, minSeparationDistance);
+                if (_publishMetrics)
+                    Metrics::standard().neighborQueries.add (i - others.begin() + 1);
+                OPENSTEER_ANNOTATE (annotateAvoidCloseNeighbor
+                                    (other, minSeparationDistance));
                 return (-offset).perpendicularComponent (forward());
             }
         }
     }
 
     // otherwise return zero
+    if (_publishMetrics)
+        Metrics::standard().neighborQueries.add (others.size ());
     return Vec3::zero;
 }
 
@@ -826,6 +945,10 @@ steerForSeparation (const float maxDistance,
         }
     }
 
+    if (_publishMetrics)
+
+        Metrics::standard().neighborQueries.add (flock.size ());
+
     // divide by neighbors, then normalize to pure direction
     // bk: Why dividing if you normalize afterwards?
     //     As long as normilization tests for @c 0 we can just call normalize
@@ -870,6 +993,10 @@ steerForAlignment (const float maxDistance,
         }
     }
 
+    if (_publishMetrics)
+
+        Metrics::standard().neighborQueries.add (flock.size ());
+
     // divide by neighbors, subtract off current heading to get error-
     // correcting direction, then normalize to pure direction
     if (neighbors > 0) steering = ((steering / (float)neighbors) - forward()).normalize();
@@ -907,6 +1034,10 @@ steerForCohesion (const float maxDistance,
         }
     }
 
+    if (_publishMetrics)
+
+        Metrics::standard().neighborQueries.add (flock.size ());
+
     // divide by neighbors, subtract off current position to get error-
     // correcting direction, then normalize to pure direction
     if (neighbors > 0) steering = ((steering / (float)neighbors) - position()).normalize();
@@ -933,15 +1064,51 @@ OpenSteer::Vec3
 OpenSteer::SteerLibraryMixin<Super>::
 steerForPursuit (const AbstractVehicle& quarry,
                  const float maxPredictionTime)
+{
+    const float etl = pursuitPredictionTime (quarry.position (),
+                                             quarry.forward (),
+                                             maxPredictionTime);
+
+    // estimated position of quarry at intercept
+    const Vec3 target = quarry.predictFuturePosition (etl);
+
+//    // annotation
+//    this->annotationLine (position(),
+//                          target,
+//                          gaudyPursuitAnnotation ? color : gGray40);
+
+    return steerForSeek (target);
+}
+
+
+template<class Super>
+OpenSteer::Vec3
+OpenSteer::SteerLibraryMixin<Super>::
+steerForPursuit (const QuarryState& quarry,
+                 const float maxPredictionTime)
+{
+    const float etl = pursuitPredictionTime (quarry.position,
+                                             quarry.forward,
+                                             maxPredictionTime);
+    return steerForSeek (quarry.predictFuturePosition (etl));
+}
+
+
+template<class Super>
+float
+OpenSteer::SteerLibraryMixin<Super>::
+pursuitPredictionTime (const Vec3& quarryPosition,
+                       const Vec3& quarryForward,
+                       const float maxPredictionTime) const
 {
     // offset from this to quarry, that distance, unit vector toward quarry
-    const Vec3 offset = quarry.position() - position();
+    const Vec3 offset = quarryPosition - position();
     const float distance = offset.length ();
     const Vec3 unitOffset = offset / distance;
 
     // how parallel are the paths of "this" and the quarry
     // (1 means parallel, 0 is pependicular, -1 is anti-parallel)
-    const float parallelness = forward().dot (quarry.forward());
+    const float parallelness = forward().dot (quarryForward);
 
     // how "forward" is the direction to the quarry
     // (1 means dead ahead, 0 is directly to the side, -1 is straight back)
@@ -1006,17 +1173,7 @@ steerForPursuit (const AbstractVehicle& quarry,
     const float et = directTravelTime * timeFactor;
 
     // xxx experiment, if kept, this limit should be an argument
-    const float etl = (et > maxPredictionTime) ? maxPredictionTime : et;
-
-    // estimated position of quarry at intercept
-    const Vec3 target = quarry.predictFuturePosition (etl);
-
-//    // annotation
-//    this->annotationLine (position(),
-//                          target,
-//                          gaudyPursuitAnnotation ? color : gGray40);
-
-    return steerForSeek (target);
+    return (et > maxPredictionTime) ? maxPredictionTime : et;
 }
 
 // ----------------------------------------------------------------------------
@@ -0,0 +1,245 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// TaskScheduler: a work-stealing pool for data parallel frame phases
+//
+// A fixed pool of worker threads, created once, each with its own queue.
+// Tasks spawned on a worker go to that worker's queue, tasks spawned from
+// any other thread go to a queue of their own.  A thread takes tasks from
+// the front of its own queue and, when that is empty, steals from the back
+// of another's.  The workers persist, so the pool is cheap enough to use
+// several times per frame (and BatchRunner reuses it across batches).  A
+// thread waiting for a group of tasks runs queued tasks meanwhile, so
+// tasks may spawn and wait for tasks of their own.  Idle workers sleep.
+//
+// parallelFor splits an index range into chunks of "grain" indices and
+// runs them as tasks.  FrameGraph runs a frame's phases (each typically a
+// parallelFor) in dependency order, phases whose dependencies are all
+// done run concurrently.
+//
+// An exception thrown by a task is caught on the thread that ran it and
+// rethrown (the first, if several) by the wait for its group, so it
+// reaches the thread that spawned the work (for parallelFor and
+// FrameGraph::run, their caller).
+//
+// Every task carries a name (a string literal).  With OPENSTEER_PROFILE
+// each task is timed as a profile zone of that name (see Profile.h), and
+// an optional hook is called after each task with its name, thread and
+// duration.
+//
+// Usage:
+//         TaskScheduler scheduler (threads, pin);
+//         scheduler.parallelFor (0, n, 256, [&] (size_t b, size_t e)
+//         {
+//             for (size_t i = b; i < e; i++) ...;
+//         }, "steer");
+//
+//         FrameGraph frame;
+//         const FrameGraph::Phase a = frame.addPhase ("rebuild", ...);
+//         const FrameGraph::Phase b = frame.addPhase ("steer", ...);
+//         frame.addDependency (a, b);
+//         frame.run (scheduler);
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#ifndef OPENSTEER_TASKSCHEDULER_H
+#define OPENSTEER_TASKSCHEDULER_H
+
+
+#include "OpenSteer/StandardTypes.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace OpenSteer {
+
+    class TaskScheduler
+    {
+    public:
+
+        typedef std::function<void (void)> Task;
+        typedef std::function<void (size_t, size_t)> RangeTask;
+
+        // called after every task on the thread that ran it
+        typedef void (*TaskHook) (const char* name,
+                                  const int thread,
+                                  const double seconds);
+
+        // tasks spawned into a group can be waited for together
+        class TaskGroup
+        {
+        public:
+            TaskGroup (void) : pending (0), failed (false) {}
+        private:
+            friend class TaskScheduler;
+            std::atomic<size_t> pending;
+            std::atomic<bool> failed;       // error is set
+            std::exception_ptr error;       // the first task's exception
+        };
+
+        // threadCount counts the calling thread, which helps while it
+        // waits: 0 uses one thread per hardware thread, 1 runs everything
+        // on the caller.  pinThreads pins workers to CPUs (Linux only).
+        TaskScheduler (const int threadCount = 0, const bool pinThreads = false);
+        ~TaskScheduler (void);
+
+        // threads working on tasks, including the waiting caller
+        int threadCount (void) const {return (int) workers.size () + 1;}
+
+        // queue a task in a group, and run queued tasks until every task
+        // in the group is done (then rethrow any task's exception)
+        void spawn (TaskGroup& group, const Task& task, const char* name);
+        void wait (TaskGroup& group);
+
+        // run body (b, e) over consecutive chunks [b, e) of [begin, end)
+        // of at most grain indices, returns when all are done.  A range of
+        // a single chunk runs directly on the calling thread.
+        void parallelFor (const size_t begin,
+                          const size_t end,
+                          const size_t grain,
+                          const RangeTask& body,
+                          const char* name);
+
+        void setTaskHook (const TaskHook h) {hook = h;}
+
+        // tasks run and stolen by each thread (the caller last) since
+        // construction or resetCounters, taken between frames
+        void printReport (std::ostream& o) const;
+        void resetCounters (void);
+        size_t tasksRun (const int thread) const;
+        size_t stealCount (void) const;
+
+    private:
+
+        struct Item
+        {
+            Task task;
+            TaskGroup* group;
+            const char* name;
+            int zone;                  // profile zone of name
+        };
+
+        // queue an item on the calling thread's queue and wake a worker
+        void push (const Item& item);
+
+        // one thread's queue and counters
+        struct Queue;
+
+        // take a task (own queue first, then steal) and run it, false if
+        // every queue was empty
+        bool runOne (const int self);
+        void execute (const Item& item, const int self);
+        void workerLoop (const int self, const int cpu);
+
+        // the queue of the calling thread: its worker's, or the last one
+        // for any thread outside the pool
+        int currentQueue (void) const;
+
+        std::vector<std::unique_ptr<Queue> > queues;
+        std::vector<std::thread> workers;
+
+        // idle workers sleep until a task is queued or the pool stops
+        std::mutex sleepMutex;
+        std::condition_variable sleepCondition;
+        std::atomic<size_t> queued;
+        bool stopping;
+
+        TaskHook hook;
+
+        // not copyable
+        TaskScheduler (const TaskScheduler&);
+        TaskScheduler& operator= (const TaskScheduler&);
+    };
+
+
+    // ----------------------------------------------------------------------------
+    // the phases of a frame and the order between them, built once and run
+    // every frame
+
+
+    class FrameGraph
+    {
+    public:
+
+        typedef size_t Phase;
+
+        FrameGraph (void) : remainingSize (0) {}
+
+        Phase addPhase (const char* name, const TaskScheduler::Task& work);
+
+        // "after" starts only when "before" is done
+        void addDependency (const Phase before, const Phase after);
+
+        // run every phase once, returns when all are done
+        void run (TaskScheduler& scheduler);
+
+        void clear (void) {phases.clear ();}
+        size_t phaseCount (void) const {return phases.size ();}
+
+        // wall clock duration of a phase in the last run
+        const char* phaseName (const Phase p) const {return phases[p].name;}
+        double phaseSeconds (const Phase p) const {return phases[p].seconds;}
+
+    private:
+
+        struct Node
+        {
+            const char* name;
+            TaskScheduler::Task work;
+            std::vector<Phase> successors;
+            size_t dependencies;
+            double seconds;
+        };
+
+        void start (TaskScheduler& scheduler,
+                    TaskScheduler::TaskGroup& group,
+                    const Phase p);
+
+        std::vector<Node> phases;
+
+        // dependencies of each phase not yet done in the current run
+        std::unique_ptr<std::atomic<size_t>[]> remaining;
+        size_t remainingSize;
+    };
+
+} // namespace OpenSteer
+
+
+// ----------------------------------------------------------------------------
+#endif // OPENSTEER_TASKSCHEDULER_H
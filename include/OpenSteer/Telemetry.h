@@ -0,0 +1,268 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// Telemetry: binary stream of per-frame agent states for offline analysis
+//
+// TelemetryWriter appends one record per frame holding every agent's id,
+// position, heading (yaw about +Y, radians) and speed to a fixed size,
+// memory-mapped ring file: when the ring is full the oldest frames are
+// overwritten, so a long run keeps its most recent history in bounded
+// disk space.
+//
+// The simulation thread only encodes a frame into an in-memory staging
+// ring (no locks, syscalls or file I/O; no allocation once the agent count
+// has been seen); a background thread moves staged frames into the mapped
+// file and flushes it.  If the staging ring is too full for a frame (the
+// disk can not keep up) that frame is dropped and counted rather than
+// waited for.
+//
+// Two encodings:
+//     raw:        id, position (3 floats), heading, speed: 24 bytes/agent
+//     quantized:  position on a fixed grid (positionQuantum), heading and
+//                 speed as 16 bit fixed point; positions are sent as 16 bit
+//                 deltas from the same agent's previous frame where
+//                 possible: 11 bytes/agent, 21 for keyframe entries.
+//                 Every keyframeInterval frames (and after a dropped
+//                 frame) a keyframe stores absolute values only, readers
+//                 of a wrapped ring start at the oldest keyframe.
+//
+// Everything is in native byte order.  TelemetryReader decodes a file
+// written by a writer that has been closed (it is meant for
+// post-processing; see SharedState.h for watching a run live).
+//
+// Usage:
+//         TelemetryWriter telemetry;
+//         telemetry.open ("run.telemetry", TelemetryWriter::Options ());
+//         each frame:
+//             telemetry.beginFrame (frame, time, vehicles.size ());
+//             for (...) telemetry.addAgent (id, position, forward, speed);
+//             telemetry.endFrame ();
+//         telemetry.close ();
+//
+//         TelemetryReader reader;
+//         TelemetryReader::Frame f;
+//         if (reader.open ("run.telemetry"))
+//             while (reader.next (f)) ... f.agents[i].position ...
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#ifndef OPENSTEER_TELEMETRY_H
+#define OPENSTEER_TELEMETRY_H
+
+
+#include "OpenSteer/Vec3.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <stdint.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+namespace OpenSteer {
+
+    namespace Telemetry {
+
+        // current file format version
+        const uint32_t version = 1;
+
+        enum Format
+        {
+            raw = 0,
+            quantized = 1
+        };
+
+        // one agent in one frame, as decoded by the reader
+        struct AgentState
+        {
+            uint32_t id;
+            Vec3 position;
+            float heading;
+            float speed;
+        };
+
+    } // namespace Telemetry
+
+
+    class TelemetryWriter
+    {
+    public:
+
+        struct Options
+        {
+            Options (void)
+                : fileBytes (64 << 20),
+                  stagingBytes (8 << 20),
+                  format (Telemetry::raw),
+                  positionQuantum (1.0f / 256),
+                  speedQuantum (1.0f / 256),
+                  keyframeInterval (60),
+                  flushSeconds (0.25)
+            {}
+
+            size_t fileBytes;           // ring file size, header included
+            size_t stagingBytes;        // in-memory staging ring
+            Telemetry::Format format;
+            float positionQuantum;      // quantized: position grid
+            float speedQuantum;         // quantized: speed step
+            int keyframeInterval;       // quantized: frames per keyframe
+            double flushSeconds;        // background flush period
+        };
+
+        TelemetryWriter (void);
+        ~TelemetryWriter (void);
+
+        // create (or truncate) and map the ring file and start the flush
+        // thread, returns false (with a message on std::cerr) on failure
+        bool open (const std::string& path, const Options& options);
+
+        // flush whatever is staged, unmap and close the file
+        void close (void);
+
+        bool isOpen (void) const {return fd >= 0;}
+
+        // encode one frame of agentCount agents (simulation thread only).
+        // beginFrame returns false if the frame is dropped, addAgent is
+        // then a no-op; endFrame publishes it to the flush thread.
+        bool beginFrame (const uint32_t frame,
+                         const float time,
+                         const size_t agentCount);
+        void addAgent (const uint32_t id,
+                       const Vec3& position,
+                       const Vec3& forward,
+                       const float speed);
+        bool endFrame (void);
+
+        uint64_t framesStaged (void) const {return staged;}
+        uint64_t framesDropped (void) const {return dropped;}
+
+    private:
+
+        // staging ring: single producer (simulation), single consumer
+        // (flush thread).  Positions are byte counts ever written/read.
+        std::vector<uint8_t> staging;
+        size_t stagingMask;
+        std::atomic<uint64_t> stagingWrite;
+        std::atomic<uint64_t> stagingRead;
+
+        void stage (const void* data, const size_t bytes);
+
+        // frame being encoded: where it starts, its cursor, whether it
+        // was dropped or is a keyframe, agents added so far
+        uint64_t frameStart;
+        uint64_t cursor;
+        bool dropping;
+        bool keyframe;
+        size_t slot;
+        uint32_t framesSinceKey;
+
+        // quantized: each slot's id and position in the previous frame
+        std::vector<uint32_t> previousId;
+        std::vector<int32_t> previousPosition;
+        size_t previousCount;
+
+        // frame being encoded: header fields
+        uint32_t pendingFrame;
+        float pendingTime;
+        size_t pendingCount;
+
+        Options options;
+        std::atomic<uint64_t> staged;
+        std::atomic<uint64_t> dropped;
+
+        // the mapped file and the flush thread's position in its ring
+        void flushLoop (void);
+        void drain (void);
+        int fd;
+        uint8_t* mapping;
+        size_t mappingBytes;
+        std::thread flusher;
+        std::mutex flushMutex;
+        std::condition_variable flushCondition;
+        bool stopping;
+
+        // not copyable
+        TelemetryWriter (const TelemetryWriter&);
+        TelemetryWriter& operator= (const TelemetryWriter&);
+    };
+
+
+    class TelemetryReader
+    {
+    public:
+
+        struct Frame
+        {
+            uint32_t frame;
+            float time;
+            bool keyframe;
+            std::vector<Telemetry::AgentState> agents;
+        };
+
+        // read a closed telemetry file into memory, returns false (with a
+        // message on std::cerr) if it can not be read or is not telemetry
+        bool open (const std::string& path);
+
+        // decode the next frame, oldest first, false at the end.  Quantized
+        // streams start at their oldest keyframe.
+        bool next (Frame& f);
+
+        Telemetry::Format format (void) const {return fileFormat;}
+
+        // frames the writer staged and dropped over its whole run (a
+        // wrapped ring holds fewer)
+        uint64_t framesStaged (void) const {return stagedCount;}
+        uint64_t framesDropped (void) const {return droppedCount;}
+
+    private:
+
+        std::vector<uint8_t> records;
+        size_t position;
+        Telemetry::Format fileFormat;
+        float positionQuantum;
+        float speedQuantum;
+        uint64_t stagedCount;
+        uint64_t droppedCount;
+        bool sawKeyframe;
+
+        // quantized: each slot's id and position in the previous frame
+        std::vector<uint32_t> previousId;
+        std::vector<int32_t> previousPosition;
+        size_t previousCount;
+    };
+
+} // namespace OpenSteer
+
+
+// ----------------------------------------------------------------------------
+#endif // OPENSTEER_TELEMETRY_H
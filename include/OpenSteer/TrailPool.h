@@ -0,0 +1,79 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// TrailPool: shared storage for AnnotationMixin's trail ring buffers
+//
+// A trail needs two parallel rings of vertexCount entries: vertex positions
+// and flag bytes.  Rather than two heap allocations per vehicle, trails are
+// carved from chunks of fixed-size blocks (one block holds both rings), kept
+// on a free list per vertexCount.  Most vehicles never record a trail and so
+// never take a block; those which do return it when their trail history is
+// cleared or they are destroyed.  Chunks are retained for reuse.
+//
+// Acquire and release take a lock, they happen at most once per trail
+// (re)start, never per recorded vertex.
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#ifndef OPENSTEER_TRAILPOOL_H
+#define OPENSTEER_TRAILPOOL_H
+
+
+#include "OpenSteer/Vec3.h"
+
+
+namespace OpenSteer {
+
+    class TrailPool
+    {
+    public:
+        // get storage for a ring of vertexCount vertices and flags
+        // (contents are unspecified)
+        static void acquire (const int vertexCount,
+                             Vec3*& vertices,
+                             char*& flags);
+
+        // give it back (vertices must be as returned by acquire, with the
+        // same vertexCount), sets both pointers to NULL
+        static void release (const int vertexCount,
+                             Vec3*& vertices,
+                             char*& flags);
+
+        // number of blocks in use / allocated, for diagnostics
+        static int blocksInUse (void);
+        static int blocksAllocated (void);
+    };
+
+} // namespace OpenSteer
+
+
+// ----------------------------------------------------------------------------
+#endif // OPENSTEER_TRAILPOOL_H
@@ -44,13 +44,15 @@
 
 
 #include <iostream>  // for ostream, <<, etc.
-#include <cstdlib>   // for rand, etc.
+#include <cstdlib>   // for abs, etc.
 #include <cfloat>    // for FLT_MAX, etc.
 #include <cmath>     // for sqrt, etc.
 #include <vector>    // for std::vector
 #include <cassert>   // for assert
 #include <limits>    // for numeric_limits
 
+#include "OpenSteer/Random.h"
+
 // ----------------------------------------------------------------------------
 // For the sake of Windows, apparently this is a "Linux/Unix thing"
 
@@ -79,21 +81,35 @@ namespace OpenSteer {
 
     // ----------------------------------------------------------------------------
     // Random number utilities
+    //
+    // The versions without a RandomStream argument draw from the calling
+    // thread's stream (see Random.h), not from the C library's rand().
 
 
     // Returns a float randomly distributed between 0 and 1
 
+    inline float frandom01 (RandomStream& random)
+    {
+        return random.next01 ();
+    }
+
     inline float frandom01 (void)
     {
-        return (((float) rand ()) / ((float) RAND_MAX));
+        return frandom01 (threadRandomStream ());
     }
 
 
     // Returns a float randomly distributed between lowerBound and upperBound
 
+    inline float frandom2 (float lowerBound, float upperBound,
+                           RandomStream& random)
+    {
+        return lowerBound + (frandom01 (random) * (upperBound - lowerBound));
+    }
+
     inline float frandom2 (float lowerBound, float upperBound)
     {
-        return lowerBound + (frandom01 () * (upperBound - lowerBound));
+        return frandom2 (lowerBound, upperBound, threadRandomStream ());
     }
 
 
@@ -167,14 +183,24 @@ namespace OpenSteer {
     inline float scalarRandomWalk (const float initial, 
                                    const float walkspeed,
                                    const float min,
-                                   const float max)
+                                   const float max,
+                                   RandomStream& random)
     {
-        const float next = initial + (((frandom01() * 2) - 1) * walkspeed);
+        const float next = initial + (((frandom01(random) * 2) - 1) * walkspeed);
         if (next < min) return min;
         if (next > max) return max;
         return next;
     }
 
+    inline float scalarRandomWalk (const float initial, 
+                                   const float walkspeed,
+                                   const float min,
+                                   const float max)
+    {
+        return scalarRandomWalk (initial, walkspeed, min, max,
+                                 threadRandomStream ());
+    }
+
 
     // ----------------------------------------------------------------------------
 
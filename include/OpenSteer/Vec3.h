@@ -259,6 +259,7 @@ namespace OpenSteer {
     // between 0 and 1
 
 
+    Vec3 RandomVectorInUnitRadiusSphere (RandomStream& random);
     Vec3 RandomVectorInUnitRadiusSphere (void);
 
 
@@ -268,6 +269,7 @@ namespace OpenSteer {
     // random and length will range between 0 and 1
 
 
+    Vec3 randomVectorOnUnitRadiusXZDisk (RandomStream& random);
     Vec3 randomVectorOnUnitRadiusXZDisk (void);
 
 
@@ -277,6 +279,11 @@ namespace OpenSteer {
     // and length will be 1
 
 
+    inline Vec3 RandomUnitVector (RandomStream& random)
+    {
+        return RandomVectorInUnitRadiusSphere(random).normalize();
+    }
+
     inline Vec3 RandomUnitVector (void)
     {
         return RandomVectorInUnitRadiusSphere().normalize();
@@ -289,6 +296,11 @@ namespace OpenSteer {
     // random and length will be 1
 
 
+    inline Vec3 RandomUnitVectorOnXZPlane (RandomStream& random)
+    {
+        return RandomVectorInUnitRadiusSphere(random).setYtoZero().normalize();
+    }
+
     inline Vec3 RandomUnitVectorOnXZPlane (void)
     {
         return RandomVectorInUnitRadiusSphere().setYtoZero().normalize();
@@ -0,0 +1,105 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// BatchRunner: runs many independent tasks (e.g. whole worlds) in parallel
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#include "OpenSteer/BatchRunner.h"
+
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <ostream>
+
+
+// ----------------------------------------------------------------------------
+
+
+OpenSteer::BatchRunner::BatchRunner (const int threadCount,
+                                     const bool pinThreads)
+    : scheduler (threadCount, pinThreads)
+{
+}
+
+
+OpenSteer::BatchRunner::Report 
+OpenSteer::BatchRunner::run (const size_t count,
+                             const std::function<uint64_t (size_t)>& task)
+{
+    scheduler.resetCounters ();
+    std::atomic<uint64_t> work (0);
+
+    const std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now ();
+
+    TaskScheduler::TaskGroup group;
+    for (size_t i = 0; i < count; i++)
+        scheduler.spawn (group, [&task, &work, i] () {work += task (i);},
+                         "batch task");
+    scheduler.wait (group);
+
+    Report report;
+    report.seconds = std::chrono::duration<double>
+        (std::chrono::steady_clock::now () - start).count ();
+    report.tasks = count;
+    report.threads = scheduler.threadCount ();
+    report.work = work;
+    report.steals = scheduler.stealCount ();
+    for (int t = 0; t < report.threads; t++)
+        report.tasksPerThread.push_back (scheduler.tasksRun (t));
+    return report;
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+void 
+OpenSteer::BatchRunner::printReport (std::ostream& o,
+                                     const Report& r,
+                                     const char* workUnit)
+{
+    const double s = r.seconds > 0 ? r.seconds : 1e-9;
+    o << "batch: " << r.tasks << " tasks on " << r.threads << " threads in "
+      << std::fixed << std::setprecision (3) << r.seconds << " seconds, "
+      << std::setprecision (1) << (r.tasks / s) << " tasks/s, "
+      << std::setprecision (0) << (r.work / s) << " " << workUnit
+      << "/s, " << r.steals << " stolen" << std::endl;
+    o << "batch: tasks per thread:";
+    for (size_t i = 0; i < r.tasksPerThread.size (); i++)
+        o << " " << r.tasksPerThread[i];
+    o << std::endl;
+    o.unsetf (std::ios::floatfield);
+}
+
+
+// ----------------------------------------------------------------------------
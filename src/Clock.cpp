@@ -40,6 +40,8 @@
 // Usage: allocate a clock, set its "paused" or "targetFPS" parameters,
 // then call updateGlobalSimulationClock before each simulation step.
 //
+// All bookkeeping is done in integer steady_clock ticks, see Clock.h
+//
 // 10-04-04 bk:  put everything into the OpenSteer namespace
 // 09-24-02 cwr: major overhaul
 // 06-26-02 cwr: created
@@ -52,21 +54,20 @@
 
 
 // ----------------------------------------------------------------------------
-// XXX This is a bit ad hoc.  Need to revisit conditionalization on operating
-// XXX system.  As of 5-5-03, this module knows about Win32 (code thanks to
-// XXX Leaf Garland and Bruce Mitchener) and Linux/Unix (Craig's original
-// XXX version).  It tests for Xbox and Win32 and assumes Linux/Unix 
-// XXX otherwise.
+// std::chrono::steady_clock is the portable time source.  On Linux it is
+// CLOCK_MONOTONIC, which lets sleepWait block with an absolute deadline
+// via clock_nanosleep; elsewhere std::this_thread::sleep_until is used.
 
 
-#if defined (_XBOX)
-	#include <xtl.h>
-#elif defined (_WIN32)
-	#include <windows.h>
+#if defined (__linux__)
+	#include <time.h>
+	#include <errno.h>
 #else
-	#include <sys/time.h> 
+	#include <thread>
 #endif
 
+#include <iomanip>
+
 
 // ----------------------------------------------------------------------------
 // Constructor
@@ -80,6 +81,12 @@ OpenSteer::Clock::Clock (void)
     setAnimationMode (false);
     setVariableFrameRateMode (true);
 
+    // when a fixed frame rate is used, sleep until just before each frame
+    // boundary and only spin for the last two milliseconds
+    setFrameWaitMode (sleepWait);
+    setFrameWaitSlack (0.002f);
+    resetWakeJitter ();
+
     // real "wall clock" time since launch
     totalRealTime = 0;
 
@@ -105,13 +112,8 @@ OpenSteer::Clock::Clock (void)
     // "manually" advance clock by this amount on next update
     newAdvanceTime = 0;
 
-    // "Calendar time" when this clock was first updated
-#ifdef _WIN32
-    basePerformanceCounter = 0;  // from QueryPerformanceCounter on Windows
-#else
-    baseRealTimeSec = 0;         // from gettimeofday on Linux and Mac OS X
-    baseRealTimeUsec = 0;
-#endif
+    // steady_clock time when this clock was first updated
+    baseRealTimeSet = false;
 
     // clock keeps track of "smoothed" running average of recent frame rates.
     // When a fixed frame rate is used, a running average of "CPU load" is
@@ -142,10 +144,10 @@ OpenSteer::Clock::update (void)
     frameRateSync ();
 
     // save previous real time to measure elapsed time
-    const float previousRealTime = totalRealTime;
+    const Ticks previousRealTime = totalRealTime;
 
     // real "wall clock" time since this application was launched
-    totalRealTime = realTimeSinceFirstClockUpdate ();
+    totalRealTime = realTicksSinceFirstClockUpdate ();
 
     // time since last clock update
     elapsedRealTime = totalRealTime - previousRealTime;
@@ -154,13 +156,13 @@ OpenSteer::Clock::update (void)
     if (paused) totalPausedTime += elapsedRealTime;
 
     // save previous simulation time to measure elapsed time
-    const float previousSimulationTime = totalSimulationTime;
+    const Ticks previousSimulationTime = totalSimulationTime;
 
     // update total simulation time
     if (getAnimationMode ())
     {
         // for "animation mode" use fixed frame time, ignore real time
-        const float frameDuration = 1.0f / getFixedFrameRate ();
+        const Ticks frameDuration = ticksPerSecond / getFixedFrameRate ();
         totalSimulationTime += paused ? newAdvanceTime : frameDuration;
         if (!paused) newAdvanceTime += frameDuration - elapsedRealTime;
     }
@@ -183,15 +185,19 @@ OpenSteer::Clock::update (void)
 
     // reset advance amount
     newAdvanceTime = 0;
+
+    // per-frame timing distributions
+    recordFrameHistograms ();
 }
 
 
 // ----------------------------------------------------------------------------
-// "wait" until next frame time (actually spin around this tight loop)
-//
+// "wait" until next frame time
 //
-// (xxx there are probably a smarter ways to do this (using events or
-// thread waits (eg usleep)) but they are likely to be unportable. xxx)
+// In spinWait mode this polls the clock in a tight loop.  In sleepWait mode
+// (the default) the thread sleeps on the monotonic clock until
+// frameWaitSlack seconds before the frame boundary, then spins for the
+// remainder.
 
 
 void 
@@ -202,17 +208,136 @@ OpenSteer::Clock::frameRateSync (void)
     if ((! getAnimationMode ()) && (! getVariableFrameRateMode ()))
     {
         // find next (real time) frame start time
-        const float targetStepSize = 1.0f / getFixedFrameRate ();
-        const float now = realTimeSinceFirstClockUpdate ();
-        const int lastFrameCount = (int) (now / targetStepSize);
-        const float nextFrameTime = (lastFrameCount + 1) * targetStepSize;
+        const Ticks targetStepSize = ticksPerSecond / getFixedFrameRate ();
+        const Ticks now = realTicksSinceFirstClockUpdate ();
+        const Ticks lastFrameCount = now / targetStepSize;
+        const Ticks nextFrameTime = (lastFrameCount + 1) * targetStepSize;
 
         // record usage ("busy time", "non-wait time") for OpenSteerDemo app
         elapsedNonWaitRealTime = now - totalRealTime;
 
         // wait until next frame time
-        do {} while (realTimeSinceFirstClockUpdate () < nextFrameTime); 
+        waitUntilRealTime (nextFrameTime);
+
+        // keep statistics on how precisely we hit the frame boundary
+        recordWakeJitter (realTicksSinceFirstClockUpdate () - nextFrameTime);
+    }
+}
+
+
+void 
+OpenSteer::Clock::waitUntilRealTime (const Ticks targetTime)
+{
+    if (getFrameWaitMode () == sleepWait)
+    {
+        const Ticks wakeTime = targetTime - secondsToTicks (getFrameWaitSlack ());
+        if (wakeTime > realTicksSinceFirstClockUpdate ())
+        {
+            const std::chrono::steady_clock::time_point deadline =
+                baseRealTime + std::chrono::nanoseconds (wakeTime);
+#if defined (__linux__)
+            // absolute deadline on CLOCK_MONOTONIC (steady_clock's epoch),
+            // so an interrupted sleep is simply resumed without drifting
+            const int64_t ns = std::chrono::duration_cast
+                <std::chrono::nanoseconds> (deadline.time_since_epoch ()).count ();
+            timespec ts;
+            ts.tv_sec = (time_t) (ns / ticksPerSecond);
+            ts.tv_nsec = (long) (ns % ticksPerSecond);
+            while (clock_nanosleep (CLOCK_MONOTONIC, TIMER_ABSTIME,
+                                    &ts, 0) == EINTR) {}
+#else
+            std::this_thread::sleep_until (deadline);
+#endif
+        }
+    }
+
+    // spin for whatever remains (all of it in spinWait mode)
+    do {} while (realTicksSinceFirstClockUpdate () < targetTime); 
+}
+
+
+// ----------------------------------------------------------------------------
+// wake-up jitter statistics
+
+
+void 
+OpenSteer::Clock::recordWakeJitter (const Ticks lateness)
+{
+    if ((wakeJitterCount == 0) || (lateness < wakeJitterMin))
+        wakeJitterMin = lateness;
+    if ((wakeJitterCount == 0) || (lateness > wakeJitterMax))
+        wakeJitterMax = lateness;
+    wakeJitterSum += lateness;
+    wakeJitterCount++;
+}
+
+
+void 
+OpenSteer::Clock::resetWakeJitter (void)
+{
+    wakeJitterCount = 0;
+    wakeJitterSum = 0;
+    wakeJitterMin = 0;
+    wakeJitterMax = 0;
+}
+
+
+// ----------------------------------------------------------------------------
+// per-frame timing histograms
+//
+// in variable frame rate mode there is no waiting: the whole frame counts
+// as non-wait time.
+
+
+void 
+OpenSteer::Clock::recordFrameHistograms (void)
+{
+    // the very first update only establishes the time base
+    if (totalRealTime == elapsedRealTime) return;
+
+    const bool waiting = ((! getAnimationMode ()) &&
+                          (! getVariableFrameRateMode ()));
+    const Ticks nonWait = waiting ? elapsedNonWaitRealTime : elapsedRealTime;
+
+    frameTimeHistogram.record (elapsedRealTime);
+    nonWaitTimeHistogram.record (nonWait);
+    waitTimeHistogram.record (elapsedRealTime - nonWait);
+}
+
+
+void 
+OpenSteer::Clock::resetHistograms (void)
+{
+    frameTimeHistogram.reset ();
+    nonWaitTimeHistogram.reset ();
+    waitTimeHistogram.reset ();
+}
+
+
+void 
+OpenSteer::Clock::printHistogramSummary (std::ostream& o) const
+{
+    const Histogram* h[] = {&frameTimeHistogram,
+                            &nonWaitTimeHistogram,
+                            &waitTimeHistogram};
+    const char* name[] = {"frame", "non-wait", "wait"};
+
+    const std::ios::fmtflags flags = o.flags ();
+    const std::streamsize precision = o.precision ();
+    o << std::fixed << std::setprecision (3)
+      << "clock (ms)       p50       p99      p999       max"
+      << "  (" << frameTimeHistogram.count () << " frames)" << std::endl;
+    for (int i = 0; i < 3; i++)
+    {
+        o << std::setw (10) << std::left << name[i] << std::right
+          << std::setw (10) << h[i]->valueAtPercentile (50.0) / 1.0e6
+          << std::setw (10) << h[i]->valueAtPercentile (99.0) / 1.0e6
+          << std::setw (10) << h[i]->valueAtPercentile (99.9) / 1.0e6
+          << std::setw (10) << h[i]->max () / 1.0e6
+          << std::endl;
     }
+    o.flags (flags);
+    o.precision (precision);
 }
 
 
@@ -246,65 +371,39 @@ OpenSteer::Clock::advanceSimulationTime (const float seconds)
         std::cerr << "negative arg to advanceSimulationTime - results will not be valid";
     }
     else
-        newAdvanceTime += seconds;
+        newAdvanceTime += secondsToTicks (seconds);
 }
 
 
-namespace {
-
 // ----------------------------------------------------------------------------
-// Returns the number of seconds of real time (represented as a float) since
-// the clock was first updated.
-//
-// XXX Need to revisit conditionalization on operating system.
+// Returns the amount of real time since the clock was first updated, read
+// from std::chrono::steady_clock.  (steady_clock cannot fail or go
+// backwards, so the old "problem reading system clock" path is gone.)
 
 
+OpenSteer::Clock::Ticks 
+OpenSteer::Clock::realTicksSinceFirstClockUpdate (void)
+{
+    const std::chrono::steady_clock::time_point now =
+        std::chrono::steady_clock::now ();
 
-    float 
-    clockErrorExit (void)
+    // ensure the base time is recorded once after launch
+    if (! baseRealTimeSet)
     {
-        /// @todo - throw? how to handle error conditions? Not by crashing an app!
-        std::cerr << "Problem reading system clock - results will not be valid";
-        return 0.0f;
+        baseRealTime = now;
+        baseRealTimeSet = true;
     }
 
-} // anonymous namespace
+    return std::chrono::duration_cast<std::chrono::nanoseconds>
+        (now - baseRealTime).count ();
+}
+
 
 float 
 OpenSteer::Clock::realTimeSinceFirstClockUpdate (void)
-#ifdef _WIN32
-{
-    // get time from Windows
-    LONGLONG counter, frequency;
-    bool clockOK = (QueryPerformanceCounter ((LARGE_INTEGER *)&counter)  &&
-                    QueryPerformanceFrequency ((LARGE_INTEGER *)&frequency));
-    if (!clockOK) return clockErrorExit ();
-
-    // ensure the base counter is recorded once after launch
-    if (basePerformanceCounter == 0) basePerformanceCounter = counter;
-
-    // real "wall clock" time since launch
-    const LONGLONG counterDifference = counter - basePerformanceCounter;
-    return ((float) counterDifference) / ((float)frequency);
-}
-#else
 {
-    // get time from Linux (Unix, Mac OS X, ...)
-    timeval t;
-    if (gettimeofday (&t, 0) != 0) return clockErrorExit ();
-
-    // ensure the base time is recorded once after launch
-    if (baseRealTimeSec == 0)
-    {
-        baseRealTimeSec = t.tv_sec;
-        baseRealTimeUsec = t.tv_usec;
-    }
-
-    // real "wall clock" time since launch
-    return (( t.tv_sec  - baseRealTimeSec) +
-            ((t.tv_usec - baseRealTimeUsec) / 1000000.0f));
+    return ticksToSeconds (realTicksSinceFirstClockUpdate ());
 }
-#endif
 
 
 // ----------------------------------------------------------------------------
@@ -0,0 +1,369 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// ControlServer: drive a running simulation from another local process
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#include "OpenSteer/ControlServer.h"
+
+#include <cmath>
+#include <cstring>
+#include <errno.h>
+#include <iostream>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+
+namespace {
+
+    bool controlError (const std::string& path, const char* problem)
+    {
+        std::cerr << "ControlServer: " << path << ": " << problem << std::endl;
+        return false;
+    }
+
+    bool setNonBlocking (const int fd)
+    {
+        const int flags = fcntl (fd, F_GETFL, 0);
+        return flags >= 0 && fcntl (fd, F_SETFL, flags | O_NONBLOCK) == 0;
+    }
+
+    template <class T> void append (std::vector<unsigned char>& buffer,
+                                    const T& value)
+    {
+        const unsigned char* bytes = (const unsigned char*) &value;
+        buffer.insert (buffer.end (), bytes, bytes + sizeof (value));
+    }
+
+} // anonymous namespace
+
+
+// ----------------------------------------------------------------------------
+
+
+OpenSteer::ControlServer::ControlServer (const size_t queueCapacity)
+    : commands (queueCapacity),
+      back (0),
+      front (1),
+      middle (2),
+      listener (-1),
+      stopping (false)
+{
+    for (int i = 0; i < 3; i++) snapshots[i].frame = 0;
+}
+
+
+OpenSteer::ControlServer::~ControlServer (void)
+{
+    close ();
+}
+
+
+bool 
+OpenSteer::ControlServer::open (const std::string& path)
+{
+    close ();
+
+    sockaddr_un address;
+    std::memset (&address, 0, sizeof (address));
+    address.sun_family = AF_UNIX;
+    if (path.size () >= sizeof (address.sun_path))
+        return controlError (path, "socket path too long");
+    std::strcpy (address.sun_path, path.c_str ());
+
+    listener = socket (AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0) return controlError (path, "can not create socket");
+    unlink (path.c_str ());
+    if (bind (listener, (sockaddr*) &address, sizeof (address)) != 0 ||
+        listen (listener, 8) != 0)
+    {
+        ::close (listener);
+        listener = -1;
+        return controlError (path, "can not listen on socket");
+    }
+
+    socketPath = path;
+    stopping = false;
+    service = std::thread (&ControlServer::serve, this);
+    return true;
+}
+
+
+void 
+OpenSteer::ControlServer::close (void)
+{
+    if (listener < 0) return;
+    stopping = true;
+    if (service.joinable ()) service.join ();
+    for (size_t i = 0; i < clients.size (); i++) ::close (clients[i].fd);
+    clients.clear ();
+    ::close (listener);
+    listener = -1;
+    unlink (socketPath.c_str ());
+}
+
+
+// ----------------------------------------------------------------------------
+// snapshots: triple buffer
+
+
+void 
+OpenSteer::ControlServer::endPublish (void)
+{
+    back = middle.exchange (back | fresh) & ~fresh;
+}
+
+
+void 
+OpenSteer::ControlServer::takeLatestSnapshot (void)
+{
+    if (! (middle.load () & fresh)) return;
+    front = middle.exchange (front) & ~fresh;
+
+    const Snapshot& s = snapshots[front];
+    if (! s.positions.empty ())
+        grid.rebuild (&s.positions[0], s.positions.size (), 5);
+    else
+        grid.rebuild (0, 0, 5);
+}
+
+
+// ----------------------------------------------------------------------------
+// service thread
+
+
+void 
+OpenSteer::ControlServer::serve (void)
+{
+    std::vector<pollfd> fds;
+    while (! stopping)
+    {
+        // the listener, then every client: a client with a response still
+        // to send is waited on for that, otherwise for its next request.
+        // Wake regularly to notice close.
+        fds.resize (clients.size () + 1);
+        fds[0].fd = listener;
+        fds[0].events = POLLIN;
+        for (size_t i = 0; i < clients.size (); i++)
+        {
+            const Client& c = clients[i];
+            fds[i + 1].fd = c.fd;
+            fds[i + 1].events = c.sent < c.output.size () ? POLLOUT : POLLIN;
+        }
+        if (poll (&fds[0], fds.size (), 100) <= 0) continue;
+
+        for (size_t i = clients.size (); i > 0; i--)
+        {
+            const short events = fds[i].revents;
+            if (! events) continue;
+            Client& c = clients[i - 1];
+            const bool ok = (events & POLLOUT) ?
+                flush (c) && handleRequests (c) :
+                receive (c) && handleRequests (c);
+            if (! ok)
+            {
+                ::close (c.fd);
+                clients.erase (clients.begin () + (i - 1));
+            }
+        }
+        if (fds[0].revents & POLLIN)
+        {
+            Client c;
+            c.fd = accept (listener, 0, 0);
+            c.sent = 0;
+            if (c.fd < 0) continue;
+            if (setNonBlocking (c.fd)) clients.push_back (c);
+            else ::close (c.fd);
+        }
+    }
+}
+
+
+// read what has arrived from a client (one read per wake up, so a client
+// sending without pause can not hold the service thread), false on error
+// or disconnect
+bool 
+OpenSteer::ControlServer::receive (Client& client)
+{
+    unsigned char buffer[65536];
+    for (;;)
+    {
+        const ssize_t r = recv (client.fd, buffer, sizeof (buffer), 0);
+        if (r > 0)
+        {
+            client.input.insert (client.input.end (), buffer, buffer + r);
+            return true;
+        }
+        if (r < 0 && errno == EINTR) continue;
+        return r < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+    }
+}
+
+
+// send as much of a client's response as it will take, false on error
+bool 
+OpenSteer::ControlServer::flush (Client& client)
+{
+    while (client.sent < client.output.size ())
+    {
+        const ssize_t r = send (client.fd, &client.output[client.sent],
+                                client.output.size () - client.sent,
+                                MSG_NOSIGNAL);
+        if (r > 0) client.sent += r;
+        else if (r < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            return true;
+        else if (r < 0 && errno == EINTR)
+            continue;
+        else
+            return false;
+    }
+    client.output.clear ();
+    client.sent = 0;
+    return true;
+}
+
+
+// answer every complete request a client has sent, one at a time, each
+// only once the previous response is sent.  False on a malformed request.
+bool 
+OpenSteer::ControlServer::handleRequests (Client& client)
+{
+    size_t used = 0;
+    while (client.output.empty () &&
+           client.input.size () - used >= sizeof (Control::RequestHeader))
+    {
+        Control::RequestHeader header;
+        std::memcpy (&header, &client.input[used], sizeof (header));
+        if (header.magic != Control::requestMagic ||
+            header.commandCount > Control::maxCommands)
+            return false;
+
+        const size_t size = sizeof (header) +
+            header.commandCount * sizeof (Control::Command);
+        if (client.input.size () - used < size) break;
+
+        answer (&client.input[used + sizeof (header)], header.commandCount,
+                client.output);
+        used += size;
+        if (! flush (client)) return false;
+    }
+    client.input.erase (client.input.begin (), client.input.begin () + used);
+    return true;
+}
+
+
+void 
+OpenSteer::ControlServer::answer (const unsigned char* request,
+                                  const size_t commandCount,
+                                  std::vector<unsigned char>& response)
+{
+    takeLatestSnapshot ();
+    const Snapshot& s = snapshots[front];
+
+    Control::ResponseHeader reply;
+    reply.magic = Control::responseMagic;
+    reply.queued = 0;
+    reply.rejected = 0;
+    reply.queries = 0;
+    reply.truncated = 0;
+    reply.records = 0;
+    reply.frame = s.frame;
+    response.assign (sizeof (reply), 0);
+
+    for (size_t i = 0; i < commandCount; i++)
+    {
+        Control::Command c;
+        std::memcpy (&c, request + i * sizeof (c), sizeof (c));
+
+        // a position that is not finite would poison the world (or the
+        // grid query), so the command is refused whatever its type
+        if (! std::isfinite (c.x) || ! std::isfinite (c.z))
+        {
+            reply.rejected++;
+            continue;
+        }
+        switch (c.type)
+        {
+        case Control::spawn:
+            if (c.count > Control::maxSpawn)
+            {
+                reply.rejected++;
+                break;
+            }
+            // fall through
+        case Control::setTarget:
+        case Control::despawn:
+            if (commands.push (c)) reply.queued++;
+            else reply.rejected++;
+            break;
+        case Control::queryRegion:
+        {
+            if (! std::isfinite (c.radius) || c.radius < 0)
+            {
+                reply.rejected++;
+                break;
+            }
+            found.clear ();
+            grid.queryRadius (Vec3 (c.x, 0, c.z), c.radius, found);
+            const uint32_t room = Control::maxRecords - reply.records;
+            if (found.size () > room)
+            {
+                found.resize (room);
+                reply.truncated++;
+            }
+            append (response, (uint32_t) found.size ());
+            for (size_t f = 0; f < found.size (); f++)
+            {
+                const Handle h = s.handles[found[f]];
+                const Vec3& p = s.positions[found[f]];
+                const Control::AgentRecord r = {h.index, h.generation,
+                                                p.x, p.z};
+                append (response, r);
+            }
+            reply.records += found.size ();
+            reply.queries++;
+            break;
+        }
+        default:
+            reply.rejected++;
+        }
+    }
+
+    std::memcpy (&response[0], &reply, sizeof (reply));
+}
+
+
+// ----------------------------------------------------------------------------
@@ -0,0 +1,161 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// Histogram: HDR-style (log-linear bucketed) histogram of integer samples
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#include "OpenSteer/Histogram.h"
+
+// Include OpenSteer::size_t
+#include "OpenSteer/StandardTypes.h"
+
+
+// ----------------------------------------------------------------------------
+// bucket layout
+//
+// indices [0, 2*subBucketCount) hold the values themselves.  Above that,
+// values in [2^m, 2^(m+1)) share a shift e = m - subBucketBits, and are
+// spread over subBucketCount linear buckets of width 2^e.
+
+
+namespace {
+
+    int mostSignificantBit (uint64_t v)
+    {
+        int m = 0;
+        while (v >>= 1) m++;
+        return m;
+    }
+
+} // anonymous namespace
+
+
+int 
+OpenSteer::Histogram::bucketIndex (const int64_t value)
+{
+    if (value < 2 * subBucketCount) return (int) value;
+
+    const int shift = mostSignificantBit (value) - subBucketBits;
+    const int top = (int) (value >> shift);  // in [subBucketCount, 2*subBucketCount)
+    return (2 * subBucketCount) +
+           ((shift - 1) * subBucketCount) +
+           (top - subBucketCount);
+}
+
+
+int64_t 
+OpenSteer::Histogram::bucketHighestValue (const int index)
+{
+    if (index < 2 * subBucketCount) return index;
+
+    const int offset = index - (2 * subBucketCount);
+    const int shift = (offset / subBucketCount) + 1;
+    const int64_t top = subBucketCount + (offset % subBucketCount);
+    return ((top + 1) << shift) - 1;
+}
+
+
+// ----------------------------------------------------------------------------
+// constructor
+
+
+OpenSteer::Histogram::Histogram (const int64_t maxTrackableValue)
+    : _maxTrackableValue (maxTrackableValue),
+      _buckets (bucketIndex (maxTrackableValue) + 1, 0)
+{
+    reset ();
+}
+
+
+// ----------------------------------------------------------------------------
+// add one sample
+
+
+void 
+OpenSteer::Histogram::record (int64_t value)
+{
+    if (value < 0) value = 0;
+    if (value > _maxTrackableValue) value = _maxTrackableValue;
+
+    _buckets[bucketIndex (value)]++;
+    if ((_count == 0) || (value < _min)) _min = value;
+    if ((_count == 0) || (value > _max)) _max = value;
+    _sum += value;
+    _count++;
+}
+
+
+// ----------------------------------------------------------------------------
+// forget all samples
+
+
+void 
+OpenSteer::Histogram::reset (void)
+{
+    for (OpenSteer::size_t i = 0; i < _buckets.size(); i++) _buckets[i] = 0;
+    _count = 0;
+    _min = 0;
+    _max = 0;
+    _sum = 0;
+}
+
+
+// ----------------------------------------------------------------------------
+// value at a given percentile
+
+
+int64_t 
+OpenSteer::Histogram::valueAtPercentile (const double percentile) const
+{
+    if (_count == 0) return 0;
+    if (percentile <= 0) return _min;
+    if (percentile >= 100) return _max;
+
+    // number of samples that must be at or below the reported value
+    int64_t needed = (int64_t) ((percentile / 100.0) * _count + 0.5);
+    if (needed < 1) needed = 1;
+
+    int64_t seen = 0;
+    for (OpenSteer::size_t i = 0; i < _buckets.size(); i++)
+    {
+        seen += _buckets[i];
+        if (seen >= needed)
+        {
+            const int64_t v = bucketHighestValue ((int) i);
+            return (v > _max) ? _max : ((v < _min) ? _min : v);
+        }
+    }
+    return _max;
+}
+
+
+// ----------------------------------------------------------------------------
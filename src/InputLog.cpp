@@ -0,0 +1,152 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// InputLog: recorded user input for deterministic replay
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#include "OpenSteer/InputLog.h"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+
+namespace {
+
+    struct FileHeader
+    {
+        char magic[8];          // "OSINPUT" zero padded
+        uint32_t version;
+        uint32_t eventCount;
+        uint64_t seed;
+        uint32_t frameCount;
+        uint32_t eventSize;     // sizeof (InputLog::Event)
+    };
+
+    const char inputLogMagic[8] = {'O', 'S', 'I', 'N', 'P', 'U', 'T', 0};
+    const uint32_t inputLogVersion = 2;
+
+    bool inputLogError (const std::string& path, const char* problem)
+    {
+        std::cerr << "InputLog: " << path << ": " << problem << std::endl;
+        return false;
+    }
+
+} // anonymous namespace
+
+
+// ----------------------------------------------------------------------------
+
+
+void 
+OpenSteer::InputLog::add (const Event::Type type,
+                          const uint32_t frame,
+                          const float time,
+                          const float x,
+                          const float z,
+                          const uint32_t arg,
+                          const uint32_t count)
+{
+    Event e;
+    e.frame = frame;
+    e.type = type;
+    e.time = time;
+    e.x = x;
+    e.z = z;
+    e.arg = arg;
+    e.count = count;
+    events.push_back (e);
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+bool 
+OpenSteer::InputLog::write (const std::string& path) const
+{
+    FileHeader header;
+    std::memset (&header, 0, sizeof (header));
+    std::memcpy (header.magic, inputLogMagic, sizeof (header.magic));
+    header.version = inputLogVersion;
+    header.eventCount = (uint32_t) events.size ();
+    header.seed = _seed;
+    header.frameCount = _frameCount;
+    header.eventSize = sizeof (Event);
+
+    std::ofstream o (path.c_str (), std::ios::binary | std::ios::trunc);
+    if (!o) return inputLogError (path, "cannot open for writing");
+
+    o.write ((const char*) &header, sizeof (header));
+    if (! events.empty ())
+        o.write ((const char*) &events[0], events.size () * sizeof (Event));
+    o.flush ();
+    if (!o) return inputLogError (path, "write failed");
+    return true;
+}
+
+
+bool 
+OpenSteer::InputLog::read (const std::string& path)
+{
+    std::ifstream in (path.c_str (), std::ios::binary);
+    if (!in) return inputLogError (path, "cannot open for reading");
+
+    FileHeader header;
+    in.read ((char*) &header, sizeof (header));
+    if (!in) return inputLogError (path, "truncated header");
+    if (std::memcmp (header.magic, inputLogMagic, sizeof (header.magic)) != 0)
+        return inputLogError (path, "not an input log");
+    if (header.version != inputLogVersion ||
+        header.eventSize != sizeof (Event))
+        return inputLogError (path, "unsupported input log version");
+
+    // check the count against the file's length before sizing by it
+    const std::streamoff start = in.tellg ();
+    in.seekg (0, std::ios::end);
+    const uint64_t available = (uint64_t) (in.tellg () - start);
+    in.seekg (start);
+    if (header.eventCount > available / sizeof (Event))
+        return inputLogError (path, "truncated event data");
+
+    events.resize (header.eventCount);
+    if (! events.empty ())
+        in.read ((char*) &events[0], events.size () * sizeof (Event));
+    if (!in) return inputLogError (path, "truncated event data");
+
+    _seed = header.seed;
+    _frameCount = header.frameCount;
+    return true;
+}
+
+
+// ----------------------------------------------------------------------------
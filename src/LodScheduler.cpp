@@ -0,0 +1,236 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// LodScheduler: level-of-detail time slicing of agent updates
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#include "OpenSteer/LodScheduler.h"
+#include "OpenSteer/Utilities.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+
+
+// ----------------------------------------------------------------------------
+
+
+OpenSteer::LodScheduler::LodScheduler (void)
+    : indexed (false),
+      useGrid (false),
+      reach (0),
+      frame (0),
+      longestPeriod (1),
+      _stepsRun (0),
+      _stepsSkipped (0)
+{
+}
+
+
+void 
+OpenSteer::LodScheduler::setTiers (const std::vector<Tier>& t)
+{
+    tiers = t;
+    tierCount.assign (tiers.size (), 0);
+    lastStep.clear ();
+    longestPeriod = 1;
+    for (size_t i = 0; i < tiers.size (); i++)
+        longestPeriod = std::max (longestPeriod, (uint64_t) tiers[i].period);
+}
+
+
+void 
+OpenSteer::LodScheduler::beginFrame (void)
+{
+    frame++;
+    pointsOfInterest.clear ();
+    indexed = false;
+    tierCount.assign (tiers.size (), 0);
+}
+
+
+void 
+OpenSteer::LodScheduler::addPointOfInterest (const Vec3& point)
+{
+    pointsOfInterest.push_back (point);
+    indexed = false;
+}
+
+
+void 
+OpenSteer::LodScheduler::indexPoints (void)
+{
+    // a scan is cheaper than a grid query for a handful of points
+    const size_t scanLimit = 8;
+
+    indexed = true;
+    useGrid = tiers.size () > 1 && pointsOfInterest.size () > scanLimit;
+    if (! useGrid) return;
+
+    // an agent at least this far from every point is in the last tier
+    reach = tiers[tiers.size () - 2].maxDistance;
+    grid.rebuild (&pointsOfInterest[0], pointsOfInterest.size (),
+                  reach > 0 ? reach : 1);
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+OpenSteer::size_t 
+OpenSteer::LodScheduler::tierOf (const Vec3& position)
+{
+    if (! indexed) indexPoints ();
+
+    // squared distance to the nearest point of interest
+    float nearest = 0;
+    if (useGrid)
+    {
+        grid.queryNearest (position, 1, reach, nearestPoint);
+        nearest = nearestPoint.empty () ? square (reach)
+                                        : nearestPoint[0].first;
+    }
+    else
+    {
+        for (size_t i = 0; i < pointsOfInterest.size (); i++)
+        {
+            const float d = (position - pointsOfInterest[i]).lengthSquared ();
+            if (i == 0 || d < nearest) nearest = d;
+        }
+    }
+
+    size_t t = 0;
+    while (t + 1 < tiers.size () &&
+           nearest >= square (tiers[t].maxDistance))
+        t++;
+    return t;
+}
+
+
+uint64_t& 
+OpenSteer::LodScheduler::lastStepOf (const size_t agent)
+{
+    if (agent >= lastStep.size ()) lastStep.resize (agent + 1, frame - 1);
+    return lastStep[agent];
+}
+
+
+int 
+OpenSteer::LodScheduler::stepMultiplier (const size_t agent,
+                                         const Vec3& position)
+{
+    if (tiers.empty ())
+    {
+        _stepsRun++;
+        return 1;
+    }
+
+    const size_t t = tierOf (position);
+    tierCount[t]++;
+
+    // step on the agent's staggered frame, or as soon as it is owed a
+    // whole period (after moving from a tier with another stagger).  The
+    // step covers every frame since the last, which (coming from a
+    // coarser tier) may be more than this tier's period but never more
+    // than the longest.
+    const uint64_t period = std::max (1, tiers[t].period);
+    uint64_t& last = lastStepOf (agent);
+    const uint64_t owed = frame - last;
+    if (owed >= period || (frame + agent) % period == 0)
+    {
+        last = frame;
+        _stepsRun++;
+        return (int) std::max ((uint64_t) 1, std::min (owed, longestPeriod));
+    }
+    _stepsSkipped++;
+    return 0;
+}
+
+
+void 
+OpenSteer::LodScheduler::hold (const size_t agent)
+{
+    // frames owed from before the hold stay owed
+    if (tiers.empty ()) return;
+    uint64_t& last = lastStepOf (agent);
+    if (last != frame) last++;
+}
+
+
+void 
+OpenSteer::LodScheduler::restart (const size_t agent)
+{
+    if (! tiers.empty ()) lastStepOf (agent) = frame;
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+float 
+OpenSteer::LodScheduler::savedFraction (void) const
+{
+    const uint64_t total = _stepsRun + _stepsSkipped;
+    return total ? (float) _stepsSkipped / total : 0;
+}
+
+
+void 
+OpenSteer::LodScheduler::resetCounters (void)
+{
+    _stepsRun = 0;
+    _stepsSkipped = 0;
+}
+
+
+void 
+OpenSteer::LodScheduler::printReport (std::ostream& o) const
+{
+    const std::ios::fmtflags flags = o.flags ();
+    const std::streamsize precision = o.precision ();
+    o << "LOD: " << _stepsRun << " steps run, " << _stepsSkipped
+      << " skipped (" << std::fixed << std::setprecision (1)
+      << 100 * savedFraction () << "% of work saved)";
+    o.flags (flags);
+    o.precision (precision);
+    if (! tiers.empty ())
+    {
+        o << ", agents per tier:";
+        for (size_t t = 0; t < tiers.size (); t++)
+            o << (t ? ", " : " ") << tierCount[t] << " every "
+              << tiers[t].period;
+    }
+    o << std::endl;
+}
+
+
+// ----------------------------------------------------------------------------
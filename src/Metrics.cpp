@@ -0,0 +1,256 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// Metrics: process-wide counters and gauges for production scraping
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#include "OpenSteer/Metrics.h"
+
+#include <condition_variable>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace {
+
+    // one registered metric (exactly one of counter/gauge is set).  Metrics
+    // are never unregistered or freed, references handed out stay valid.
+    struct RegistryEntry
+    {
+        std::string name;
+        std::string help;
+        OpenSteer::MetricCounter* counter;
+        OpenSteer::MetricGauge* gauge;
+    };
+
+    std::vector<RegistryEntry> registry;
+    std::mutex registryMutex;
+
+    RegistryEntry* findEntry (const std::string& name)
+    {
+        for (size_t i = 0; i < registry.size (); i++)
+            if (registry[i].name == name) return &registry[i];
+        return 0;
+    }
+
+    // background exporter
+    std::thread exporterThread;
+    std::mutex exporterMutex;
+    std::condition_variable exporterWake;
+    bool exporterStop = false;
+
+    // each thread takes the next counter shard round-robin
+    std::atomic<int> nextShard (0);
+    thread_local int threadShard = -1;
+
+} // anonymous namespace
+
+
+// ----------------------------------------------------------------------------
+// MetricCounter
+
+
+OpenSteer::MetricCounter::MetricCounter (void)
+{
+    for (int i = 0; i < shardCount; i++) shards[i].value.store (0);
+}
+
+
+int 
+OpenSteer::MetricCounter::shardIndex (void)
+{
+    if (threadShard < 0)
+        threadShard = nextShard.fetch_add (1, std::memory_order_relaxed) %
+                      shardCount;
+    return threadShard;
+}
+
+
+uint64_t 
+OpenSteer::MetricCounter::value (void) const
+{
+    uint64_t sum = 0;
+    for (int i = 0; i < shardCount; i++)
+        sum += shards[i].value.load (std::memory_order_relaxed);
+    return sum;
+}
+
+
+// ----------------------------------------------------------------------------
+// registry
+
+
+OpenSteer::MetricCounter& 
+OpenSteer::Metrics::counter (const std::string& name, const std::string& help)
+{
+    std::lock_guard<std::mutex> lock (registryMutex);
+    RegistryEntry* e = findEntry (name);
+    if (e && e->counter) return *e->counter;
+    if (e)
+    {
+        // the name is taken: hand out a metric which is never exported
+        std::cerr << "Metrics: " << name << " is already a gauge" << std::endl;
+        static MetricCounter detached;
+        return detached;
+    }
+
+    RegistryEntry n = {name, help, new MetricCounter, 0};
+    registry.push_back (n);
+    return *n.counter;
+}
+
+
+OpenSteer::MetricGauge& 
+OpenSteer::Metrics::gauge (const std::string& name, const std::string& help)
+{
+    std::lock_guard<std::mutex> lock (registryMutex);
+    RegistryEntry* e = findEntry (name);
+    if (e && e->gauge) return *e->gauge;
+    if (e)
+    {
+        // the name is taken: hand out a metric which is never exported
+        std::cerr << "Metrics: " << name << " is already a counter" << std::endl;
+        static MetricGauge detached;
+        return detached;
+    }
+
+    RegistryEntry n = {name, help, 0, new MetricGauge};
+    registry.push_back (n);
+    return *n.gauge;
+}
+
+
+OpenSteer::StandardMetrics& 
+OpenSteer::Metrics::standard (void)
+{
+    static StandardMetrics s =
+    {
+        gauge ("opensteer_agents",
+               "Number of agents currently simulated."),
+        gauge ("opensteer_active_agents",
+               "Number of simulated agents which are awake."),
+        counter ("opensteer_frames_total",
+                 "Simulation frames stepped."),
+        counter ("opensteer_steps_total",
+                 "Agent update steps (agents times frames)."),
+        counter ("opensteer_neighbor_queries_total",
+                 "Agent-to-agent proximity tests made by steering behaviors."),
+        counter ("opensteer_obstacle_tests_total",
+                 "Agent-to-obstacle tests made by steering behaviors."),
+        gauge ("opensteer_spatial_index_rebuild_seconds",
+               "Duration of the most recent spatial index rebuild."),
+        gauge ("opensteer_agent_bytes",
+               "Memory used per agent, in bytes.")
+    };
+    return s;
+}
+
+
+// ----------------------------------------------------------------------------
+// Prometheus text exposition format
+
+
+void 
+OpenSteer::Metrics::writePrometheus (std::ostream& o)
+{
+    std::lock_guard<std::mutex> lock (registryMutex);
+    for (size_t i = 0; i < registry.size (); i++)
+    {
+        const RegistryEntry& e = registry[i];
+        o << "# HELP " << e.name << " " << e.help << "\n"
+          << "# TYPE " << e.name << (e.counter ? " counter" : " gauge") << "\n"
+          << e.name << " ";
+        if (e.counter) o << e.counter->value ();
+        else o << e.gauge->value ();
+        o << "\n";
+    }
+}
+
+
+bool 
+OpenSteer::Metrics::writePrometheusFile (const std::string& path)
+{
+    // write a temporary file then rename, so scrapers never see partial data
+    const std::string temporary = path + ".tmp";
+    {
+        std::ofstream o (temporary.c_str ());
+        if (!o) return false;
+        writePrometheus (o);
+        if (!o) return false;
+    }
+    return std::rename (temporary.c_str (), path.c_str ()) == 0;
+}
+
+
+// ----------------------------------------------------------------------------
+// background file exporter
+
+
+void 
+OpenSteer::Metrics::startFileExporter (const std::string& path,
+                                       const float intervalSeconds)
+{
+    stopFileExporter ();
+    exporterStop = false;
+
+    const std::chrono::milliseconds interval ((long) (intervalSeconds * 1000));
+    exporterThread = std::thread ([path, interval] ()
+    {
+        std::unique_lock<std::mutex> lock (exporterMutex);
+        while (! exporterStop)
+        {
+            if (! writePrometheusFile (path))
+                std::cerr << "Metrics: cannot write " << path << std::endl;
+            exporterWake.wait_for (lock, interval);
+        }
+        writePrometheusFile (path);
+    });
+}
+
+
+void 
+OpenSteer::Metrics::stopFileExporter (void)
+{
+    if (! exporterThread.joinable ()) return;
+    {
+        std::lock_guard<std::mutex> lock (exporterMutex);
+        exporterStop = true;
+    }
+    exporterWake.notify_all ();
+    exporterThread.join ();
+}
+
+
+// ----------------------------------------------------------------------------
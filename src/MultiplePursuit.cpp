@@ -0,0 +1,821 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// MultiplePursuit: a self-contained world of wanderers and their pursuers
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#include "OpenSteer/MultiplePursuit.h"
+#include "OpenSteer/Snapshot.h"
+#include "OpenSteer/Profile.h"
+#include "OpenSteer/Metrics.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <math.h>
+
+
+// ----------------------------------------------------------------------------
+// MpPursuer
+
+
+OpenSteer::MpPursuer::MpPursuer (const std::vector<QuarryState>* q,
+                                 const size_t t,
+                                 const Scenario::Population* p,
+                                 const uint64_t seed,
+                                 const uint64_t stream)
+{
+    quarries = q;
+    target = t;
+    population = p;
+    captured = false;
+    lastSteeringForce = 0;
+    randomStream().setSeed (seed, stream);
+    reset ();
+}
+
+
+OpenSteer::MpPursuer::MpPursuer (const std::vector<QuarryState>* q,
+                                 const size_t t,
+                                 const Scenario::Population* p,
+                                 const SimpleVehicle::State& s)
+    : MpBase (s)
+{
+    quarries = q;
+    target = t;
+    population = p;
+    captured = false;
+    lastSteeringForce = 0;
+}
+
+
+void 
+OpenSteer::MpPursuer::reset (void)
+{
+    MpBase::reset ();
+    setMaxForce (population->maxForce);
+    setMaxSpeed (population->maxSpeed);
+    randomizeStartingPositionAndHeading ();
+    activity.wake ();
+}
+
+
+void 
+OpenSteer::MpPursuer::respawn (const SimpleVehicle::State& prototype)
+{
+    const RandomStream::State random = randomStream().state ();
+    setState (prototype);
+    randomStream().setState (random);
+    clearTrailHistory ();
+    randomizeStartingPositionAndHeading ();
+    captured = false;
+    activity.wake ();
+}
+
+
+OpenSteer::Vec3 
+OpenSteer::MpPursuer::pursuitSteering (const QuarryState& quarry)
+{
+    // when pursuer touches quarry ("wanderer") flag it, MpWorld respawns
+    // all captured pursuers after the step
+    const float d = Vec3::distance (position(), quarry.position);
+    const float r = radius() + quarry.radius;
+    captured = d < r;
+
+    const float maxTime = 20; // xxx hard-to-justify value
+    return steerForPursuit (quarry, maxTime);
+}
+
+
+void 
+OpenSteer::MpPursuer::applyPursuit (const Vec3& steer,
+                                    const float elapsedTime)
+{
+    applySteeringForce (steer, elapsedTime);
+    lastSteeringForce = std::min (steer.length (), maxForce ());
+}
+
+
+void 
+OpenSteer::MpPursuer::randomizeStartingPositionAndHeading (void)
+{
+    // randomize position on a ring between inner and outer radii
+    // centered around the target wanderer
+    const float inner = population->spawnInner;
+    const float outer = population->spawnOuter;
+    const float radius = frandom2 (inner, outer, randomStream ());
+    const Vec3 randomOnRing = RandomUnitVectorOnXZPlane (randomStream ()) * radius;
+    setPosition ((*quarries)[target].position + randomOnRing);
+
+    // randomize 2D heading
+    randomizeHeadingOnXZPlane ();
+}
+
+
+// ----------------------------------------------------------------------------
+// MpWorld: configuration
+
+
+OpenSteer::MpWorld::MpWorld (void)
+    : scheduler (0),
+      stepsBefore (0),
+      awakeCount (0),
+      reassignCursor (0),
+      seed (0),
+      seedSet (false),
+      nextStream (0),
+      publishMetrics (true)
+{
+    configure (Scenario ());
+}
+
+
+OpenSteer::MpWorld::~MpWorld (void)
+{
+    close ();
+}
+
+
+void 
+OpenSteer::MpWorld::configure (const Scenario& scenario)
+{
+    setPopulations (scenario.populations);
+    setWanderers (scenario.wanderers,
+                  scenario.wandererSpread,
+                  scenario.reassignFrames);
+    setLodTiers (scenario.lodTiers);
+    setSleepThresholds (scenario.sleep);
+    setAvoidance (scenario.avoidance);
+}
+
+
+void 
+OpenSteer::MpWorld::setPopulations (const std::vector<Scenario::Population>& p)
+{
+    populations = p;
+    pursuerCount = 0;
+    for (size_t i = 0; i < populations.size (); i++)
+        pursuerCount += populations[i].count;
+}
+
+
+void 
+OpenSteer::MpWorld::setWanderers (const int count,
+                                  const float spread,
+                                  const int frames)
+{
+    wandererCount = count < 1 ? 1 : count;
+    wandererSpread = spread;
+    reassignFrames = frames < 1 ? 1 : frames;
+}
+
+
+void 
+OpenSteer::MpWorld::setLodTiers (const std::vector<LodScheduler::Tier>& tiers)
+{
+    lod.setTiers (tiers);
+}
+
+
+void 
+OpenSteer::MpWorld::setSleepThresholds (const Activity::Thresholds& t)
+{
+    sleep = t;
+}
+
+
+void 
+OpenSteer::MpWorld::setSeed (const uint64_t s)
+{
+    seed = s;
+    seedSet = true;
+}
+
+
+void 
+OpenSteer::MpWorld::setPublishMetrics (const bool p)
+{
+    publishMetrics = p;
+    for (size_t i = 0; i < allMP.size (); i++)
+        allMP[i]->setPublishMetrics (p);
+    for (size_t i = 0; i < deadPursuers.size (); i++)
+        deadPursuers[i]->setPublishMetrics (p);
+}
+
+
+// ----------------------------------------------------------------------------
+// MpWorld: creation and destruction
+
+
+void 
+OpenSteer::MpWorld::open (void)
+{
+    if (! seedSet) seed = randomSeed ();
+    nextStream = 1;
+
+    // size the vehicle list and storage for the whole declared population
+    // up front, pursuers are contiguous in creation order
+    allMP.reserve (pursuerCount + wandererCount);
+    pursuers.reserve (pursuerCount);
+    wandererArena.reserve (wandererCount);
+    pursuerArena.reserve (pursuerCount);
+
+    // create the wanderers: the player's at the origin, any others evenly
+    // spaced on a circle around it
+    for (int w = 0; w < wandererCount; w++)
+    {
+        MpWanderer* wanderer = wandererArena.create ();
+        wanderer->serialNumber = w;
+        wanderer->setPublishMetrics (publishMetrics);
+        if (w > 0)
+        {
+            const float angle = (2 * OPENSTEER_M_PI * w) / wandererCount;
+            wanderer->setPosition (wandererSpread * cosf (angle), 0,
+                                   wandererSpread * sinf (angle));
+        }
+        wanderers.push_back (wanderer);
+        allMP.push_back (wanderer);
+    }
+    captureQuarries ();
+
+    // create each population's pursuers
+    for (size_t p = 0; p < populations.size (); p++)
+        for (int i = 0; i < populations[p].count; i++)
+            spawnPursuer (p);
+
+    buildRespawnPrototypes ();
+
+    if (publishMetrics)
+        Metrics::standard().agentBytes.set (sizeof (MpPursuer));
+}
+
+
+void 
+OpenSteer::MpWorld::buildRespawnPrototypes (void)
+{
+    respawnPrototypes.resize (populations.size ());
+    for (size_t p = 0; p < populations.size (); p++)
+    {
+        MpPursuer prototype (&quarries, 0, &populations[p], seed, 0);
+        prototype.getState (respawnPrototypes[p]);
+    }
+}
+
+
+void 
+OpenSteer::MpWorld::createFromStates (const std::vector<SimpleVehicle::State>& states)
+{
+    close ();
+    const size_t count = states.size () - wandererCount;
+    nextStream = count + 1;
+
+    // storage for exactly the given vehicles, each constructed in its
+    // state: no reset or random placement per vehicle
+    allMP.reserve (states.size ());
+    pursuers.reserve (count);
+    wandererArena.reserve (wandererCount);
+    pursuerArena.reserve (count);
+    for (int w = 0; w < wandererCount; w++)
+    {
+        MpWanderer* wanderer = wandererArena.create (states[w]);
+        wanderer->serialNumber = w;
+        wanderer->setPublishMetrics (publishMetrics);
+        wanderers.push_back (wanderer);
+        allMP.push_back (wanderer);
+    }
+    captureQuarries ();
+    for (size_t i = 0; i < count; i++)
+    {
+        MpPursuer* p = pursuerArena.create (&quarries, 0, &populations[0],
+                                            states[wandererCount + i]);
+        p->serialNumber = (int) (wandererCount + i);
+        p->setPublishMetrics (publishMetrics);
+        allMP.push_back (p);
+        pursuers.insert (p);
+    }
+    if (publishMetrics) Metrics::standard().agents.set (allMP.size ());
+}
+
+
+void 
+OpenSteer::MpWorld::close (void)
+{
+    // destroy wanderers and all pursuers, and clear list
+    pursuers.clear ();
+    pendingDespawn.clear ();
+    deadPursuers.clear ();
+    pursuerArena.clear ();
+    wanderers.clear ();
+    wandererArena.clear ();
+    allMP.clear();
+    reassignCursor = 0;
+    lod.clearHistory ();
+    if (publishMetrics) Metrics::standard().agents.set (0);
+}
+
+
+void 
+OpenSteer::MpWorld::reset (void)
+{
+    for (size_t w = 0; w < wanderers.size (); w++) wanderers[w]->reset ();
+    for (size_t i = 0; i < pursuers.size (); i++) pursuers[i]->reset ();
+}
+
+
+// ----------------------------------------------------------------------------
+// MpWorld: spawn and despawn
+
+
+OpenSteer::Handle 
+OpenSteer::MpWorld::spawnPursuer (const size_t population)
+{
+    // reuse a despawned pursuer if there is any.  New pursuers are dealt
+    // out to the wanderers in turn, reassignment later moves them to their
+    // nearest.
+    const size_t target = pursuers.size () % wanderers.size ();
+    MpPursuer* p;
+    if (deadPursuers.empty ())
+    {
+        p = pursuerArena.create (&quarries, target, &populations[population],
+                                 seed, nextStream);
+        p->serialNumber = (int) (wanderers.size () + nextStream - 1);
+        p->setPublishMetrics (publishMetrics);
+        nextStream++;
+    }
+    else
+    {
+        p = deadPursuers.back ();
+        deadPursuers.pop_back ();
+        p->setPopulation (&populations[population]);
+        p->setTarget (target);
+        p->reset ();
+    }
+    allMP.push_back (p);
+    if (publishMetrics) Metrics::standard().agents.set (allMP.size ());
+
+    // its steps are owed from the next frame on, whoever had its slot
+    const Handle h = pursuers.insert (p);
+    lod.restart (h.index);
+    return h;
+}
+
+
+void 
+OpenSteer::MpWorld::despawnPursuer (const Handle h)
+{
+    pendingDespawn.push_back (h);
+}
+
+
+void 
+OpenSteer::MpWorld::applyDespawns (void)
+{
+    for (size_t i = 0; i < pendingDespawn.size (); i++)
+    {
+        const Handle h = pendingDespawn[i];
+        if (! pursuers.valid (h)) continue;
+        const size_t d = pursuers.denseIndex (h);
+        deadPursuers.push_back (pursuers[d]);
+        pursuers.remove (h);
+        allMP[d + wanderers.size ()] = allMP.back ();
+        allMP.pop_back ();
+    }
+    pendingDespawn.clear ();
+    if (publishMetrics) Metrics::standard().agents.set (allMP.size ());
+}
+
+
+void 
+OpenSteer::MpWorld::wakePursuer (const Handle h)
+{
+    if (MpPursuer** p = pursuers.get (h)) (*p)->activity.wake ();
+}
+
+
+void 
+OpenSteer::MpWorld::wakeAllPursuers (void)
+{
+    for (size_t i = 0; i < pursuers.size (); i++)
+        pursuers[i]->activity.wake ();
+}
+
+
+OpenSteer::Handle 
+OpenSteer::MpWorld::nearestPursuer (void)
+{
+    Handle nearest;
+    float nearestDistance = 0;
+    for (size_t i = 0; i < pursuers.size (); i++)
+    {
+        const float d = Vec3::distance (pursuers[i]->position (),
+                                        getWanderer()->position ());
+        if (nearest.isNull () || d < nearestDistance)
+        {
+            nearest = pursuers.handleAt (i);
+            nearestDistance = d;
+        }
+    }
+    return nearest;
+}
+
+
+// ----------------------------------------------------------------------------
+// MpWorld: simulation step
+
+
+void 
+OpenSteer::MpWorld::update_hero (const float /*elapsedTime*/, Vec3 location)
+{
+    // update the player's wanderer
+    getWanderer()->setPosition(location.x, location.y, location.z);
+    //        wanderer->update (elapsedTime, location);
+}
+
+
+void 
+OpenSteer::MpWorld::captureQuarries (void)
+{
+    quarries.resize (wanderers.size ());
+    quarryPositions.resize (wanderers.size ());
+    for (size_t w = 0; w < wanderers.size (); w++)
+    {
+        quarries[w] = QuarryState (*wanderers[w]);
+        quarryPositions[w] = quarries[w].position;
+    }
+
+    OPENSTEER_PROFILE_ZONE ("spatialIndexRebuild");
+    const std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now ();
+    quarryGrid.rebuild (&quarryPositions[0], quarryPositions.size (),
+                        wandererSpread > 0 ? wandererSpread : 1);
+    if (publishMetrics)
+        Metrics::standard().spatialIndexRebuildSeconds.set
+            (std::chrono::duration<double>
+             (std::chrono::steady_clock::now () - start).count ());
+}
+
+
+void 
+OpenSteer::MpWorld::reassignTargets (void)
+{
+    OPENSTEER_PROFILE_ZONE ("reassignTargets");
+    const size_t n = pursuers.size ();
+    if (n == 0 || wanderers.size () == 1) return;
+
+    const size_t slice = (n + reassignFrames - 1) / reassignFrames;
+    for (size_t j = 0; j < slice; j++)
+    {
+        if (reassignCursor >= n) reassignCursor = 0;
+        MpPursuer* p = pursuers[reassignCursor++];
+        p->setTarget (quarryGrid.nearest (p->position ()));
+    }
+    if (publishMetrics) Metrics::standard().neighborQueries.add (slice);
+}
+
+
+void 
+OpenSteer::MpWorld::groupByTarget (void)
+{
+    targetStart.assign (wanderers.size () + 1, 0);
+    for (size_t i = 0; i < pursuers.size (); i++)
+        targetStart[pursuers[i]->getTarget () + 1]++;
+    for (size_t t = 1; t < targetStart.size (); t++)
+        targetStart[t] += targetStart[t - 1];
+
+    byTarget.resize (pursuers.size ());
+    targetCursor.assign (targetStart.begin (), targetStart.end () - 1);
+    for (size_t i = 0; i < pursuers.size (); i++)
+        byTarget[targetCursor[pursuers[i]->getTarget ()]++] = i;
+}
+
+
+void 
+OpenSteer::MpWorld::update_enemies (const float elapsedTime)
+{
+    OPENSTEER_PROFILE_ZONE ("update_enemies");
+    beginStep (elapsedTime);
+    steer ();
+    avoid ();
+    integrate ();
+    endStep ();
+}
+
+
+void 
+OpenSteer::MpWorld::beginStep (const float elapsedTime)
+{
+    OPENSTEER_PROFILE_ZONE ("rebuild");
+
+    // despawns requested since the last step take effect now
+    applyDespawns ();
+
+    // query each wanderer's state just once, then choose targets
+    captureQuarries ();
+    reassignTargets ();
+    groupByTarget ();
+
+    // tier pursuers by distance to the nearest wanderer
+    lod.beginFrame ();
+    for (size_t w = 0; w < wanderers.size (); w++)
+        lod.addPointOfInterest (quarries[w].position);
+    stepsBefore = lod.stepsRun ();
+
+    // sleeping pursuers are skipped unless their target came near
+    const float wakeRadiusSquared = square (sleep.wakeRadius);
+    awakeCount = 0;
+
+    // list the awake pursuers due this frame, one target at a time
+    // (distant ones take a longer step less often)
+    jobs.resize (pursuers.size ());
+    size_t jobCount = 0;
+    for (size_t t = 0; t < wanderers.size (); t++)
+    {
+        const Vec3 quarryPosition = quarries[t].position;
+        for (size_t j = targetStart[t]; j < targetStart[t + 1]; j++)
+        {
+            const size_t i = byTarget[j];
+            MpPursuer* p = pursuers[i];
+            const uint32_t slot = pursuers.handleAt (i).index;
+            if (p->activity.isAsleep ())
+            {
+                // time spent asleep is not owed when it wakes
+                const Vec3 offset = p->position () - quarryPosition;
+                if (offset.lengthSquared () >= wakeRadiusSquared)
+                {
+                    lod.hold (slot);
+                    continue;
+                }
+                p->activity.wake ();
+            }
+            awakeCount++;
+
+            // staggered by handle slot, which a despawn of another
+            // pursuer does not change (the dense index can)
+            const int k = lod.stepMultiplier (slot, p->position ());
+            if (k == 0) continue;
+
+            StepJob& job = jobs[jobCount++];
+            job.pursuer = p;
+            job.index = i;
+            job.target = t;
+            job.elapsedTime = k * elapsedTime;
+        }
+    }
+    jobs.resize (jobCount);
+}
+
+
+void 
+OpenSteer::MpWorld::steer (void)
+{
+    // batch pursuit: jobs are in target order, so each chunk loads few
+    // quarry states
+    const TaskScheduler::RangeTask body = [this] (size_t begin, size_t end)
+    {
+        for (size_t j = begin; j < end; j++)
+            jobs[j].steer = jobs[j].pursuer->pursuitSteering
+                (quarries[jobs[j].target]);
+    };
+    if (scheduler) scheduler->parallelFor (0, jobs.size (), jobGrain,
+                                           body, "steer");
+    else body (0, jobs.size ());
+}
+
+
+void 
+OpenSteer::MpWorld::avoid (void)
+{
+    if (orca.getOptions().maxNeighbors <= 0 || jobs.empty ()) return;
+
+    // every pursuer is a neighbor, those not stepped this frame are
+    // expected to keep their velocity
+    const size_t n = pursuers.size ();
+    avoidPosition.resize (n);
+    avoidVelocity.resize (n);
+    avoidPreferred.resize (n);
+    avoidRadius.resize (n);
+    avoidMaxSpeed.resize (n);
+    const TaskScheduler::RangeTask gather = [this] (size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; i++)
+        {
+            const MpPursuer& p = *pursuers[i];
+            avoidPosition[i] = p.position ();
+            avoidVelocity[i] = p.velocity ();
+            avoidPreferred[i] = avoidVelocity[i];
+            avoidRadius[i] = p.radius ();
+            avoidMaxSpeed[i] = p.maxSpeed ();
+        }
+    };
+    if (scheduler) scheduler->parallelFor (0, n, jobGrain, gather,
+                                           "avoidGather");
+    else gather (0, n);
+
+    // a stepped pursuer would like its pursuit velocity: the seek
+    // steering plus its velocity, at most its speed limit
+    avoidActive.resize (jobs.size ());
+    avoidStep.resize (jobs.size ());
+    avoidResult.resize (jobs.size ());
+    for (size_t j = 0; j < jobs.size (); j++)
+    {
+        const size_t i = jobs[j].index;
+        avoidActive[j] = i;
+        avoidStep[j] = jobs[j].elapsedTime;
+        avoidPreferred[i] = (jobs[j].steer + avoidVelocity[i])
+            .truncateLength (avoidMaxSpeed[i]);
+    }
+
+    const OrcaSolver::Agents agents = {n, &avoidPosition[0],
+                                       &avoidVelocity[0], &avoidPreferred[0],
+                                       &avoidRadius[0], &avoidMaxSpeed[0]};
+    orca.solve (agents, &avoidActive[0], jobs.size (), &avoidStep[0],
+                &avoidResult[0], scheduler);
+
+    // steer toward the avoiding velocity, within one (LOD) step
+    for (size_t j = 0; j < jobs.size (); j++)
+    {
+        const MpPursuer& p = *jobs[j].pursuer;
+        jobs[j].steer = (avoidResult[j] - avoidVelocity[jobs[j].index]) *
+                        (p.mass () / jobs[j].elapsedTime);
+    }
+}
+
+
+void 
+OpenSteer::MpWorld::integrate (void)
+{
+    const TaskScheduler::RangeTask body = [this] (size_t begin, size_t end)
+    {
+        for (size_t j = begin; j < end; j++)
+        {
+            MpPursuer* p = jobs[j].pursuer;
+            p->applyPursuit (jobs[j].steer, jobs[j].elapsedTime);
+            p->activity.observe (p->getLastSteeringForce (), p->speed (), sleep);
+        }
+    };
+    if (scheduler) scheduler->parallelFor (0, jobs.size (), jobGrain,
+                                           body, "integrate");
+    else body (0, jobs.size ());
+}
+
+
+void 
+OpenSteer::MpWorld::endStep (void)
+{
+    // collect captures without branching, then respawn them in a batch
+    captures.resize (jobs.size ());
+    size_t captureCount = 0;
+    for (size_t j = 0; j < jobs.size (); j++)
+    {
+        captures[captureCount] = jobs[j].index;
+        captureCount += jobs[j].pursuer->isCaptured ();
+    }
+    if (publishMetrics)
+    {
+        Metrics::standard().steps.add (lod.stepsRun () - stepsBefore);
+        Metrics::standard().activeAgents.set (awakeCount + wanderers.size ());
+    }
+
+    respawnCaptured (captureCount);
+}
+
+
+void 
+OpenSteer::MpWorld::respawnCaptured (const size_t captureCount)
+{
+    OPENSTEER_PROFILE_ZONE ("respawn");
+    for (size_t i = 0; i < captureCount; i++)
+    {
+        MpPursuer* p = pursuers[captures[i]];
+        const size_t population = p->getPopulation () - &populations[0];
+        p->respawn (respawnPrototypes[population]);
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+// MpWorld: snapshots
+
+
+bool 
+OpenSteer::MpWorld::saveSnapshot (const std::string& path,
+                                  uint64_t frame,
+                                  double simulationTime)
+{
+    std::vector<SimpleVehicle::State> states (allMP.size ());
+    for (size_t i = 0; i < allMP.size (); i++)
+        allMP[i]->getState (states[i]);
+
+    std::vector<Snapshot::Role> roles (pursuers.size ());
+    for (size_t i = 0; i < pursuers.size (); i++)
+    {
+        const MpPursuer& p = *pursuers[i];
+        roles[i].target = (uint32_t) p.getTarget ();
+        roles[i].population = (uint32_t) (p.getPopulation () - &populations[0]);
+        roles[i].quietSteps = p.activity.getQuietSteps ();
+        roles[i].asleep = p.activity.isAsleep ();
+    }
+
+    Snapshot::Info info;
+    info.randomSeed = seed;
+    info.frame = frame;
+    info.simulationTime = simulationTime;
+    info.wandererCount = wanderers.size ();
+    info.populationCount = populations.size ();
+    return Snapshot::write (path, info, states, roles);
+}
+
+
+bool 
+OpenSteer::MpWorld::loadSnapshot (const std::string& path)
+{
+    Snapshot::Info info;
+    std::vector<SimpleVehicle::State> states;
+    std::vector<Snapshot::Role> roles;
+    if (! Snapshot::read (path, info, states, roles)) return false;
+
+    // roles refer to populations by index, whose parameters are not saved
+    if (info.populationCount != populations.size () ||
+        info.wandererCount < 1)
+    {
+        std::cerr << "Snapshot: " << path << ": taken of a world with "
+                  << info.populationCount << " populations and "
+                  << info.wandererCount << " wanderers, this one has "
+                  << populations.size () << " populations" << std::endl;
+        return false;
+    }
+    std::vector<int> counts (populations.size (), 0);
+    for (size_t i = 0; i < roles.size (); i++)
+    {
+        if (roles[i].population >= counts.size () ||
+            roles[i].target >= info.wandererCount)
+        {
+            std::cerr << "Snapshot: " << path << ": pursuer " << i
+                      << " refers to a missing population or wanderer"
+                      << std::endl;
+            return false;
+        }
+        counts[roles[i].population]++;
+    }
+
+    // adopt the snapshot's wanderer and population sizes, creating the
+    // vehicles anew only if their numbers differ, every vehicle's limits
+    // are then restored from its State
+    setSeed (info.randomSeed);
+    for (size_t i = 0; i < populations.size (); i++)
+        populations[i].count = counts[i];
+    pursuerCount = (int) roles.size ();
+    wandererCount = (int) info.wandererCount;
+    if (info.wandererCount != wanderers.size () ||
+        roles.size () != pursuers.size ())
+    {
+        createFromStates (states);
+        if (respawnPrototypes.size () != populations.size ())
+            buildRespawnPrototypes ();
+    }
+    else
+    {
+        for (size_t i = 0; i < allMP.size (); i++)
+            allMP[i]->setState (states[i]);
+    }
+    for (size_t i = 0; i < pursuers.size (); i++)
+    {
+        MpPursuer& pursuer = *pursuers[i];
+        pursuer.setTarget (roles[i].target);
+        pursuer.setPopulation (&populations[roles[i].population]);
+        pursuer.activity.restore (roles[i].quietSteps, roles[i].asleep != 0);
+    }
+    return true;
+}
+
+
+// ----------------------------------------------------------------------------
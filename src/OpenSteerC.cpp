@@ -0,0 +1,371 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// OpenSteerC: C interface for embedding the steering engine
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#include "OpenSteer/OpenSteerC.h"
+#include "OpenSteer/MultiplePursuit.h"
+#include "OpenSteer/TaskScheduler.h"
+
+#include <cmath>
+#include <memory>
+#include <new>
+
+
+using namespace OpenSteer;
+
+
+namespace {
+
+    // false if any of n floats is NaN or infinite
+    bool allFinite (const float* v, const size_t n)
+    {
+        for (size_t i = 0; i < n; i++)
+            if (! std::isfinite (v[i])) return false;
+        return true;
+    }
+
+} // anonymous namespace
+
+
+struct opensteer_world
+{
+    MpWorld world;
+    std::unique_ptr<TaskScheduler> scheduler;
+    uint64_t frame;
+
+    // structure-of-arrays copy of agent state for opensteer_view:
+    // px, py, pz, vx, vy, vz
+    std::vector<float> soa[6];
+
+    size_t agentCount (void) const {return world.getPursuerCount ();}
+    MpBase& agent (const size_t i)
+    {
+        return *world.vehicles ()[world.getWandererCount () + i];
+    }
+    const MpBase& agent (const size_t i) const
+    {
+        return *world.vehicles ()[world.getWandererCount () + i];
+    }
+
+    // update the structure-of-arrays copy: every agent, or one
+    void refreshView (void);
+    void refreshAgent (const size_t i);
+};
+
+
+namespace {
+
+    void setVelocity (MpBase& v, const Vec3& velocity)
+    {
+        const float speed = velocity.length ();
+        if (speed > 0) v.regenerateOrthonormalBasisUF (velocity / speed);
+        v.setSpeed (speed);
+    }
+
+} // anonymous namespace
+
+
+void 
+opensteer_world::refreshView (void)
+{
+    const size_t n = agentCount ();
+    for (int a = 0; a < 6; a++) soa[a].resize (n);
+    scheduler->parallelFor (0, n, 1024, [this] (size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; i++) refreshAgent (i);
+    }, "refreshView");
+}
+
+
+void 
+opensteer_world::refreshAgent (const size_t i)
+{
+    const MpBase& v = agent (i);
+    const Vec3 p = v.position ();
+    const Vec3 u = v.velocity ();
+    soa[0][i] = p.x;
+    soa[1][i] = p.y;
+    soa[2][i] = p.z;
+    soa[3][i] = u.x;
+    soa[4][i] = u.y;
+    soa[5][i] = u.z;
+}
+
+
+// ----------------------------------------------------------------------------
+// creation
+
+
+void 
+opensteer_default_config (opensteer_config* config)
+{
+    if (! config) return;
+    const Scenario defaults;
+    const Scenario::Population& p = defaults.populations.front ();
+    config->seed = 0;
+    config->wanderers = defaults.wanderers;
+    config->wanderer_spread = defaults.wandererSpread;
+    config->max_force = p.maxForce;
+    config->max_speed = p.maxSpeed;
+    config->spawn_inner = p.spawnInner;
+    config->spawn_outer = p.spawnOuter;
+    config->threads = 0;
+}
+
+
+opensteer_world* 
+opensteer_create (const opensteer_config* config)
+{
+    // written so that NaN fails every test
+    if (! config ||
+        ! (config->max_force >= 0) || ! (config->max_speed >= 0) ||
+        ! (config->spawn_inner >= 0) ||
+        ! (config->spawn_inner <= config->spawn_outer) ||
+        ! std::isfinite (config->spawn_outer) ||
+        ! std::isfinite (config->max_force) ||
+        ! std::isfinite (config->max_speed) ||
+        ! std::isfinite (config->wanderer_spread))
+        return 0;
+    try
+    {
+        std::unique_ptr<opensteer_world> w (new opensteer_world);
+        w->frame = 0;
+
+        // one population, initially empty: agents are added in bulk
+        Scenario::Population p;
+        p.name = "agents";
+        p.count = 0;
+        p.maxForce = config->max_force;
+        p.maxSpeed = config->max_speed;
+        p.spawnInner = config->spawn_inner;
+        p.spawnOuter = config->spawn_outer;
+
+        const Scenario defaults;
+        w->world.setPopulations (std::vector<Scenario::Population> (1, p));
+        w->world.setWanderers (config->wanderers, config->wanderer_spread,
+                               defaults.reassignFrames);
+        w->world.setSeed (config->seed);
+        w->world.setPublishMetrics (false);
+        w->scheduler.reset (new TaskScheduler (config->threads));
+        w->world.setScheduler (w->scheduler.get ());
+        w->world.open ();
+        return w.release ();
+    }
+    catch (...)
+    {
+        return 0;
+    }
+}
+
+
+void 
+opensteer_destroy (opensteer_world* world)
+{
+    delete world;
+}
+
+
+// ----------------------------------------------------------------------------
+// agents and targets
+
+
+int 
+opensteer_add_agents (opensteer_world* world,
+                      size_t count,
+                      const float* positions,
+                      const float* velocities)
+{
+    if (! world ||
+        (positions && ! allFinite (positions, 3 * count)) ||
+        (velocities && ! allFinite (velocities, 3 * count)))
+        return OPENSTEER_ERROR_ARGUMENT;
+    try
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            world->world.spawnPursuer (0);
+            MpBase& a = world->agent (world->agentCount () - 1);
+            if (positions)
+                a.setPosition (positions[3*i], positions[3*i+1],
+                               positions[3*i+2]);
+            if (velocities)
+                setVelocity (a, Vec3 (velocities[3*i], velocities[3*i+1],
+                                      velocities[3*i+2]));
+        }
+        world->refreshView ();
+    }
+    catch (const std::bad_alloc&)
+    {
+        return OPENSTEER_ERROR_MEMORY;
+    }
+    catch (...)
+    {
+        return OPENSTEER_ERROR_INTERNAL;
+    }
+    return OPENSTEER_OK;
+}
+
+
+size_t 
+opensteer_agent_count (const opensteer_world* world)
+{
+    return world ? world->agentCount () : 0;
+}
+
+
+int 
+opensteer_set_target (opensteer_world* world, size_t w, float x, float z)
+{
+    if (! world || w >= world->world.getWandererCount () ||
+        ! std::isfinite (x) || ! std::isfinite (z))
+        return OPENSTEER_ERROR_ARGUMENT;
+    world->world.getWanderer (w)->setPosition (x, 0, z);
+    return OPENSTEER_OK;
+}
+
+
+// ----------------------------------------------------------------------------
+// stepping
+
+
+int 
+opensteer_step (opensteer_world* world, int frames, float dt)
+{
+    if (! world || frames < 0 || ! (dt >= 0) || ! std::isfinite (dt))
+        return OPENSTEER_ERROR_ARGUMENT;
+    try
+    {
+        for (int f = 0; f < frames; f++) world->world.update_enemies (dt);
+        world->frame += frames;
+        world->refreshView ();
+    }
+    catch (const std::bad_alloc&)
+    {
+        return OPENSTEER_ERROR_MEMORY;
+    }
+    catch (...)
+    {
+        return OPENSTEER_ERROR_INTERNAL;
+    }
+    return OPENSTEER_OK;
+}
+
+
+// ----------------------------------------------------------------------------
+// bulk state transfer
+
+
+int 
+opensteer_get_positions (const opensteer_world* world,
+                         float* out,
+                         size_t capacity)
+{
+    if (! world || ! out) return OPENSTEER_ERROR_ARGUMENT;
+    const size_t n = world->agentCount ();
+    if (capacity < n) return OPENSTEER_ERROR_CAPACITY;
+    for (size_t i = 0; i < n; i++)
+    {
+        const Vec3 p = world->agent (i).position ();
+        out[3*i] = p.x;
+        out[3*i+1] = p.y;
+        out[3*i+2] = p.z;
+    }
+    return OPENSTEER_OK;
+}
+
+
+int 
+opensteer_get_velocities (const opensteer_world* world,
+                          float* out,
+                          size_t capacity)
+{
+    if (! world || ! out) return OPENSTEER_ERROR_ARGUMENT;
+    const size_t n = world->agentCount ();
+    if (capacity < n) return OPENSTEER_ERROR_CAPACITY;
+    for (size_t i = 0; i < n; i++)
+    {
+        const Vec3 v = world->agent (i).velocity ();
+        out[3*i] = v.x;
+        out[3*i+1] = v.y;
+        out[3*i+2] = v.z;
+    }
+    return OPENSTEER_OK;
+}
+
+
+int 
+opensteer_set_positions (opensteer_world* world, const float* in, size_t count)
+{
+    if (! world || ! in || count > world->agentCount ())
+        return OPENSTEER_ERROR_ARGUMENT;
+    for (size_t i = 0; i < count; i++)
+    {
+        world->agent (i).setPosition (in[3*i], in[3*i+1], in[3*i+2]);
+        world->refreshAgent (i);
+    }
+    return OPENSTEER_OK;
+}
+
+
+int 
+opensteer_set_velocities (opensteer_world* world, const float* in, size_t count)
+{
+    if (! world || ! in || count > world->agentCount ())
+        return OPENSTEER_ERROR_ARGUMENT;
+    for (size_t i = 0; i < count; i++)
+    {
+        setVelocity (world->agent (i), Vec3 (in[3*i], in[3*i+1], in[3*i+2]));
+        world->refreshAgent (i);
+    }
+    return OPENSTEER_OK;
+}
+
+
+int 
+opensteer_view (const opensteer_world* world, opensteer_soa_view* view)
+{
+    if (! world || ! view) return OPENSTEER_ERROR_ARGUMENT;
+    view->count = world->soa[0].size ();
+    view->frame = world->frame;
+    view->px = world->soa[0].data ();
+    view->py = world->soa[1].data ();
+    view->pz = world->soa[2].data ();
+    view->vx = world->soa[3].data ();
+    view->vy = world->soa[4].data ();
+    view->vz = world->soa[5].data ();
+    return OPENSTEER_OK;
+}
+
+
+// ----------------------------------------------------------------------------
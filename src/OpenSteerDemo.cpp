@@ -48,207 +48,30 @@
 #include <string>
 #include <sstream>
 #include <iomanip>
+#include <chrono>
+#include <memory>
 
 #include <math.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
 
-#include "OpenSteer/SimpleVehicle.h"
+#include "OpenSteer/MultiplePursuit.h"
+#include "OpenSteer/Clock.h"
+#include "OpenSteer/Profile.h"
+#include "OpenSteer/Metrics.h"
+#include "OpenSteer/InputLog.h"
+#include "OpenSteer/Scenario.h"
+#include "OpenSteer/BatchRunner.h"
+#include "OpenSteer/TaskScheduler.h"
+#include "OpenSteer/Telemetry.h"
+#include "OpenSteer/SharedState.h"
+#include "OpenSteer/ControlServer.h"
 #include <opencv2/opencv.hpp>
 
 
-namespace {
-
-
 using namespace OpenSteer;
 
-// ----------------------------------------------------------------------------
-// This PlugIn uses two vehicle types: MpWanderer and MpPursuer.  They have
-// a common base class, MpBase, which is a specialization of SimpleVehicle.
-
-
-class MpBase : public SimpleVehicle
-{
-public:
-
-    // constructor
-    MpBase () {
-        reset ();
-    }
-
-    // reset state
-    void reset (void)
-    {
-        SimpleVehicle::reset (); // reset the vehicle
-        setSpeed (0);            // speed along Forward direction.
-        setMaxForce (5.0);       // steering force is clipped to this magnitude
-        setMaxSpeed (3.0);       // velocity is clipped to this magnitude
-        clearTrailHistory ();    // prevent long streaks due to teleportation
-    }
-
-};
-
-
-class MpWanderer : public MpBase
-{
-public:
-
-    // constructor
-    MpWanderer () {
-        reset ();
-    }
-
-    // reset state
-    void reset (void)
-    {
-        MpBase::reset ();
-    }
-
-    // one simulation step
-    void update (const float elapsedTime, Vec3 location)
-    {
-        const Vec3 wander2d = location;//steerForWander (elapsedTime).setYtoZero ();
-        const Vec3 steer = forward() + (wander2d * 3);
-        applySteeringForce (steer, elapsedTime);
-    }
-
-};
-
-
-class MpPursuer : public MpBase
-{
-    MpWanderer* wanderer;
-public:
-
-    // constructor
-    MpPursuer (MpWanderer* w) {
-        wanderer = w;
-        reset ();
-    }
-
-    // reset state
-    void reset (void)
-    {
-        MpBase::reset ();
-        randomizeStartingPositionAndHeading ();
-    }
-
-    // one simulation step
-    void update (const float elapsedTime, Vec3 location)
-    {
-        // when pursuer touches quarry ("wanderer"), reset its position
-        const float d = Vec3::distance (position(), wanderer->position());
-        const float r = radius() + wanderer->radius();
-        if (d < r) reset ();
-
-        const float maxTime = 20; // xxx hard-to-justify value
-
-        applySteeringForce (steerForPursuit (*wanderer, maxTime), elapsedTime);
-
-    }
-
-    // reset position
-    void randomizeStartingPositionAndHeading (void)
-    {
-        // randomize position on a ring between inner and outer radii
-        // centered around the home base
-        const float inner = 20;
-        const float outer = 30;
-        const float radius = frandom2 (inner, outer);
-        const Vec3 randomOnRing = RandomUnitVectorOnXZPlane () * radius;
-        setPosition (wanderer->position() + randomOnRing);
-
-        // randomize 2D heading
-        randomizeHeadingOnXZPlane ();
-    }
-
-
-};
-
-
-// ----------------------------------------------------------------------------
-// PlugIn for OpenSteerDemo
-
-
-class MpPlugIn{
-
-
-
-    // a group (STL vector) of all vehicles
-    std::vector<MpBase*> allMP;
-    typedef std::vector<MpBase*>::const_iterator iterator;
-    iterator pBegin, pEnd;
-
-    MpWanderer* wanderer;
-
-    int pursuerCount;
-
-public:
-
-    AVGroup& allVehicles (void) {
-        return (AVGroup&) allMP;
-    }
-
-
-    MpPlugIn(int n){
-        pursuerCount = n;
-    }
-    virtual ~MpPlugIn() {} // be more "nice" to avoid a compiler warning
-
-    void open (void)
-    {
-        // create the wanderer, saving a pointer to it
-        wanderer = new MpWanderer;
-        allMP.push_back (wanderer);
-
-        // create the specified number of pursuers, save pointers to them
-        for (int i = 0; i < pursuerCount; i++)
-            allMP.push_back (new MpPursuer (wanderer));
-        pBegin = allMP.begin() + 1;  // iterator pointing to first pursuer
-        pEnd = allMP.end();          // iterator pointing to last pursuer
-    }
-
-    void update_hero (const float elapsedTime, Vec3 location)
-    {
-        // update the wanderer
-        wanderer->setPosition(location.x, location.y, location.z);
-        //        wanderer->update (elapsedTime, location);
-    }
-
-    void update_enemies(const float elapsedTime){
-
-        // update each pursuer
-        for (iterator i = pBegin; i != pEnd; i++)
-        {
-
-            ((MpPursuer&) (**i)).update (elapsedTime, Vec3(0,0,0));
-        }
-    }
-
-    void close (void)
-    {
-        std::cout<<std::endl;
-        // delete wanderer, all pursuers, and clear list
-        delete (wanderer);
-        for (iterator i = pBegin; i != pEnd; i++) delete ((MpPursuer*)*i);
-        allMP.clear();
-    }
-
-    void reset (void)
-    {
-        // reset wanderer and pursuers
-        wanderer->reset ();
-        for (iterator i = pBegin; i != pEnd; i++) ((MpPursuer&)(**i)).reset ();
-    }
-
-    MpWanderer* getWanderer(void){
-        return wanderer;
-    }
-
-};
-
-}
 
 // ----------------------------------------------------------------------------
 // currently selected vehicle.  Generally the one the camera follows and
@@ -257,17 +80,55 @@ public:
 OpenSteer::AbstractVehicle* OpenSteer::OpenSteerDemo::selectedVehicle = NULL;
 
 
-MpPlugIn MpObj(8);
+// configured by OpenSteer::loadScenario (defaults: see Scenario.h)
+Scenario scenario;
+MpWorld MpObj;
 float elapsedTime = 0.006;
 int world_size = 1000;
 float offset = (float)world_size/2;
 float multi = 20;
+uint32_t runFrames = 0;
 int wanderer_size = 20;
 cv::Point Red, Green, Blue, White;
 cv::Mat WorldMat;
 
+// real time clock, measures frame time distribution (press 'f' to print)
+Clock frameClock;
+
+// input recording (--record) and headless replay (--replay), see InputLog.h
+InputLog inputLog;
+std::string inputRecordPath;
+uint32_t frameIndex = 0;
+
+// a frame's phases (rebuild, steer, integrate, render prep) run on a pool
+// of worker threads (--workers, --pin-workers), see TaskScheduler.h
+int workerThreads = 0;
+bool pinWorkers = false;
+std::unique_ptr<TaskScheduler> scheduler;
+FrameGraph frameGraph;
+
+// vehicles' window positions, computed by the render prep phase
+std::vector<cv::Point> screenPositions;
+
+// per frame agent states streamed to a ring file (--telemetry), see
+// Telemetry.h
+TelemetryWriter telemetry;
+std::string telemetryPath;
+bool telemetryQuantized = false;
+
+// agent arrays published to shared memory for external viewers (--share),
+// see SharedState.h
+SharedStateWriter share;
+std::string shareName;
+
+// commands from other processes over a Unix domain socket (--control),
+// see ControlServer.h
+ControlServer control;
+std::string controlPath;
+
 
 void genWorld(cv::Mat & world_Mat){
+    OPENSTEER_PROFILE_ZONE ("genWorld");
 
     int rad = 20;
     int thick = 50;
@@ -283,12 +144,87 @@ cv::Point getWorldPosition(Vec3 point){
     return cv::Point(point.x*multi+offset, point.z*multi+offset);
 }
 
-Vec3 setPlayerPosition(MpPlugIn *mp, int x, int y){
-    mp->update_hero (elapsedTime, Vec3((x-offset)/multi, 0, (y-offset)/multi));
+void recordInput (const InputLog::Event::Type type, float x, float z,
+                  uint32_t arg = 0, uint32_t count = 0){
+    if (inputRecordPath.empty ()) return;
+    inputLog.add (type, frameIndex, frameClock.getTotalRealTime (), x, z,
+                  arg, count);
 }
 
+Vec3 setPlayerPosition(MpWorld *mp, int x, int y){
+    const Vec3 target ((x-offset)/multi, 0, (y-offset)/multi);
+    recordInput (InputLog::Event::playerTarget, target.x, target.z);
+    mp->update_hero (elapsedTime, target);
+    return target;
+}
+
+void movePlayer(MpWorld *mp, float dx, float dz){
+    recordInput (InputLog::Event::playerMove, dx, dz);
+    const Vec3 position = mp->getWanderer()->position();
+    mp->getWanderer()->setPosition(position.x + dx, 0.f, position.z + dz);
+}
+
+// FNV-1a hash over all vehicle positions, printed at the end of recording
+// and replay so the two trajectories can be compared
+uint64_t trajectoryChecksum (void){
+    const std::vector<MpBase*>& vehicles = MpObj.vehicles ();
+    uint64_t h = 14695981039346656037ULL;
+    for (size_t i = 0; i < vehicles.size (); i++)
+    {
+        const Vec3 p = vehicles[i]->position ();
+        const unsigned char* bytes = (const unsigned char*) &p;
+        for (size_t b = 0; b < sizeof (p); b++)
+            h = (h ^ bytes[b]) * 1099511628211ULL;
+    }
+    return h;
+}
+
+// remove the pursuer closest to the player (at the next step)
 void killEnemy(){
+    recordInput (InputLog::Event::killEnemy, 0, 0);
+    const Handle nearest = MpObj.nearestPursuer ();
+    if (! nearest.isNull ()) MpObj.despawnPursuer (nearest);
+}
+
+// add a pursuer of the first population
+void spawnEnemy(){
+    recordInput (InputLog::Event::spawnEnemy, 0, 0);
+    MpObj.spawnPursuer (0);
+}
 
+// the world changing control commands, recorded like the keys above
+void setWandererTarget(uint32_t wanderer, float x, float z){
+    if (wanderer >= MpObj.getWandererCount ()) return;
+    recordInput (InputLog::Event::wandererTarget, x, z, wanderer);
+    MpObj.getWanderer (wanderer)->setPosition (x, 0, z);
+}
+
+void spawnPursuers(uint32_t population, uint32_t count){
+    if (population >= MpObj.getPopulationCount ()) return;
+    recordInput (InputLog::Event::spawnPursuers, 0, 0, population, count);
+    for (uint32_t i = 0; i < count; i++) MpObj.spawnPursuer (population);
+}
+
+void despawnPursuer(uint32_t index, uint32_t generation){
+    recordInput (InputLog::Event::despawnPursuer, 0, 0, index, generation);
+    MpObj.despawnPursuer (Handle (index, generation));
+}
+
+void applyInputEvent(const InputLog::Event& e){
+    if (e.type == InputLog::Event::playerTarget)
+        MpObj.update_hero (elapsedTime, Vec3 (e.x, 0, e.z));
+    else if (e.type == InputLog::Event::playerMove)
+        movePlayer (&MpObj, e.x, e.z);
+    else if (e.type == InputLog::Event::killEnemy)
+        killEnemy ();
+    else if (e.type == InputLog::Event::spawnEnemy)
+        spawnEnemy ();
+    else if (e.type == InputLog::Event::wandererTarget)
+        setWandererTarget (e.arg, e.x, e.z);
+    else if (e.type == InputLog::Event::spawnPursuers)
+        spawnPursuers (e.arg, e.count);
+    else if (e.type == InputLog::Event::despawnPursuer)
+        despawnPursuer (e.arg, e.count);
 }
 
 
@@ -327,23 +263,118 @@ void CallBackFunc(int event, int x, int y, int flags, void* userdata)
 }
 
 
+// append this frame's vehicle states to the telemetry ring
+void writeTelemetry(){
+    const std::vector<MpBase*>& vehicles = MpObj.vehicles ();
+    if (! telemetry.beginFrame (frameIndex, frameIndex * elapsedTime,
+                                vehicles.size ()))
+        return;
+    for (size_t i = 0; i < vehicles.size (); i++)
+    {
+        const MpBase& v = *vehicles[i];
+        telemetry.addAgent (v.serialNumber, v.position (), v.forward (),
+                            v.speed ());
+    }
+    telemetry.endFrame ();
+}
+
+// close the telemetry ring and say what went into it
+void closeTelemetry(){
+    if (! telemetry.isOpen ()) return;
+    telemetry.close ();
+    std::cout << "telemetry: " << telemetry.framesStaged () << " frames ("
+              << telemetry.framesDropped () << " dropped) to "
+              << telemetryPath << std::endl;
+}
+
+// publish this frame's vehicle states to the shared memory segment,
+// written in place by the workers
+void publishSharedState(){
+    const std::vector<MpBase*>& vehicles = MpObj.vehicles ();
+    const SharedState::View v = share.beginWrite (frameIndex,
+                                                  frameIndex * elapsedTime);
+    const uint32_t count = std::min ((uint32_t) vehicles.size (), v.capacity);
+    scheduler->parallelFor (0, count, 1024, [&] (size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; i++)
+        {
+            const MpBase& a = *vehicles[i];
+            v.id[i] = a.serialNumber;
+            v.x[i] = a.position ().x;
+            v.y[i] = a.position ().y;
+            v.z[i] = a.position ().z;
+            v.heading[i] = atan2f (a.forward ().x, a.forward ().z);
+            v.speed[i] = a.speed ();
+        }
+    }, "shareAgents");
+    share.endWrite (v, count);
+}
+
+// apply the commands clients queued since the last step.  Spawns are
+// limited per step (commands past the limit wait for later steps) so that
+// no amount of client requests can stall stepping.  Like key input they
+// are applied after the step, so a replay applies their recorded events
+// at the same point.
+void applyControlCommands(){
+    const uint32_t spawnsPerStep = 4 * Control::maxSpawn;
+    uint32_t spawned = 0;
+    Control::Command c;
+    while (spawned < spawnsPerStep && control.pollCommand (c))
+    {
+        if (c.type == Control::setTarget)
+            setWandererTarget (c.arg, c.x, c.z);
+        else if (c.type == Control::spawn)
+        {
+            const uint32_t count = std::min (c.count, Control::maxSpawn);
+            spawnPursuers (c.arg, count);
+            spawned += count;
+        }
+        else if (c.type == Control::despawn)
+            despawnPursuer (c.arg, c.count);
+    }
+}
+
+// publish this frame's pursuer handles and positions for clients' queries
+void publishControlSnapshot(){
+    ControlServer::Snapshot& s = control.beginPublish ();
+    const std::vector<MpBase*>& vehicles = MpObj.vehicles ();
+    const size_t first = MpObj.getWandererCount ();
+    s.frame = frameIndex;
+    s.handles.resize (vehicles.size () - first);
+    s.positions.resize (vehicles.size () - first);
+    for (size_t i = 0; i < s.handles.size (); i++)
+    {
+        s.handles[i] = MpObj.pursuerHandle (i);
+        s.positions[i] = vehicles[first + i]->position ();
+    }
+    control.endPublish ();
+}
+
+// one fixed time step of the simulation, independent of rendering
+void simulationStep(){
+    //Update Enemies
+    frameGraph.run (*scheduler);
+
+    if (control.isOpen ()) applyControlCommands ();
+}
+
+
 void foo(){
 
 
-    // run selected PlugIn (with simulation's current time and step size)
     // if no vehicle is selected, and some exist, select the first one
     const AVGroup& vehicles = MpObj.allVehicles ();
     if (vehicles.size() > 0) OpenSteer::OpenSteerDemo::selectedVehicle = vehicles.front();
 
-    //Update Enemies
-    MpObj.update_enemies(elapsedTime);
-
     //Draw hero Position
-    cv::circle(WorldMat, cv::Point(getWorldPosition(MpObj.getWanderer()->position())), wanderer_size, cv::Scalar(0,255,0), 5);
+    OPENSTEER_PROFILE_ZONE ("draw");
+    const size_t wandererCount = MpObj.getWandererCount ();
+    for (size_t i = 0; i < wandererCount; ++i){
+        cv::circle(WorldMat, screenPositions[i], wanderer_size, cv::Scalar(0,255,0), 5);
+    }
     //Draw Enemies position
-    for (int i = 1; i < vehicles.size() ; ++i){
-        Vec3 pos = vehicles[i]->position();
-        cv::circle(WorldMat, cv::Point(getWorldPosition(pos)), wanderer_size, cv::Scalar(0,0,255), 5);
+    for (size_t i = wandererCount; i < screenPositions.size() ; ++i){
+        cv::circle(WorldMat, screenPositions[i], wanderer_size, cv::Scalar(0,0,255), 5);
     }
 
 }
@@ -356,28 +387,63 @@ OpenSteer::run(void)
 {
     while(true)
     {
+        frameClock.update ();
+        Metrics::standard().frames.increment ();
+        OPENSTEER_PROFILE_FRAME ();
+        OPENSTEER_PROFILE_ZONE ("frame");
+
+        simulationStep();
+
         //INIT World
         WorldMat = cv::Mat(world_size, world_size, CV_8UC3);
         genWorld(WorldMat);
 
         foo();
 
-        cv::imshow("Window", WorldMat);
+        {
+            OPENSTEER_PROFILE_ZONE ("imshow");
+            cv::imshow("Window", WorldMat);
+        }
         WorldMat.deallocate();
-        char keypress = cv::waitKey(1);
-        Vec3 position = MpObj.getWanderer()->position();
+        char keypress;
+        {
+            OPENSTEER_PROFILE_ZONE ("waitKey");
+            keypress = cv::waitKey(1);
+        }
         if(keypress == 27){
+            frameIndex++;
             break;
+        }else if (keypress == 'p') {
+            OPENSTEER_PROFILE_REPORT (std::cout);
+        }else if (keypress == 't') {
+            OPENSTEER_PROFILE_CAPTURE_TRACE (120, "opensteer_trace.json");
+        }else if (keypress == 'f') {
+            frameClock.printHistogramSummary (std::cout);
+        }else if (keypress == 'k') {
+            const uint64_t frame = Metrics::standard().frames.value ();
+            MpObj.saveSnapshot ("opensteer.snapshot",
+                                frame, frame * elapsedTime);
+        }else if (keypress == 'l') {
+            // a replay could not reproduce the file's contents
+            if (! inputRecordPath.empty ())
+                std::cerr << "not loading a snapshot while recording input"
+                          << std::endl;
+            else
+                MpObj.loadSnapshot ("opensteer.snapshot");
+        }else if (keypress == 'x') {
+            killEnemy();
+        }else if (keypress == 'n') {
+            spawnEnemy();
         }else if (keypress == 'w') {
-            MpObj.getWanderer()->setPosition(position.x,0.f,position.z - 0.3);
+            movePlayer(&MpObj, 0, -0.3f);
         }else if (keypress == 'a') {
-            MpObj.getWanderer()->setPosition(position.x - 0.3,0.f,position.z);
+            movePlayer(&MpObj, -0.3f, 0);
 
         }else if (keypress == 's') {
-            MpObj.getWanderer()->setPosition(position.x,0.f,position.z + 0.3);
+            movePlayer(&MpObj, 0, 0.3f);
 
         }else if (keypress == 'd') {
-            MpObj.getWanderer()->setPosition(position.x + 0.3,0.f,position.z);
+            movePlayer(&MpObj, 0.3f, 0);
 
         }else if (keypress == 'q') {
 
@@ -388,22 +454,260 @@ OpenSteer::run(void)
             setPlayerPosition(&MpObj, Blue.x, Blue.y);
 
         }
+        frameIndex++;
+        if (runFrames && frameIndex >= runFrames) break;
+    }
+
+    if (! inputRecordPath.empty ())
+    {
+        inputLog.setFrameCount (frameIndex);
+        if (inputLog.write (inputRecordPath))
+            std::cout << "recorded " << inputLog.frameCount ()
+                      << " frames, " << inputLog.events.size ()
+                      << " input events to " << inputRecordPath
+                      << ", trajectory checksum " << std::hex
+                      << trajectoryChecksum () << std::dec << std::endl;
     }
+    closeTelemetry ();
+    share.close ();
+    control.close ();
+    frameClock.printHistogramSummary (std::cout);
+    MpObj.printLodReport (std::cout);
+    scheduler->printReport (std::cout);
+    OPENSTEER_PROFILE_REPORT (std::cout);
 }
 
-void
-OpenSteer::OpenSteerDemo::initialize (void)
+
+// ----------------------------------------------------------------------------
+// set up the world without any window, shared by interactive and replay runs
+
+
+void initializeWorld (const bool render)
 {
     Red = cv::Point(world_size*0.25, world_size*0.25);
     Green = cv::Point(world_size*0.75, world_size*0.25);
     Blue = cv::Point(world_size*0.25, world_size*0.75);
     White= cv::Point(world_size*0.75, world_size*0.75);
 
+    OpenSteer::OpenSteerDemo::selectedVehicle = NULL;
+    MpObj.open ();
 
+    // the frame: rebuild -> steer -> avoid -> integrate -> render prep,
+    // all but the first spread over the workers
+    scheduler.reset (new TaskScheduler (workerThreads, pinWorkers));
+    MpObj.setScheduler (scheduler.get ());
+    frameGraph.clear ();
+    const FrameGraph::Phase rebuild = frameGraph.addPhase ("rebuildPhase", [] ()
+    {
+        MpObj.beginStep (elapsedTime);
+    });
+    const FrameGraph::Phase steer = frameGraph.addPhase ("steerPhase", [] ()
+    {
+        MpObj.steer ();
+    });
+    const FrameGraph::Phase avoid = frameGraph.addPhase ("avoidPhase", [] ()
+    {
+        MpObj.avoid ();
+    });
+    const FrameGraph::Phase integrate = frameGraph.addPhase ("integratePhase", [] ()
+    {
+        MpObj.integrate ();
+        MpObj.endStep ();
+    });
+    frameGraph.addDependency (rebuild, steer);
+    frameGraph.addDependency (steer, avoid);
+    frameGraph.addDependency (avoid, integrate);
+    if (render)
+    {
+        const FrameGraph::Phase renderPrep = frameGraph.addPhase ("renderPrep", [] ()
+        {
+            const std::vector<MpBase*>& vehicles = MpObj.vehicles ();
+            screenPositions.resize (vehicles.size ());
+            scheduler->parallelFor (0, vehicles.size (), 1024,
+                                    [&] (size_t begin, size_t end)
+            {
+                for (size_t i = begin; i < end; i++)
+                    screenPositions[i] = getWorldPosition (vehicles[i]->position ());
+            }, "screenPositions");
+        });
+        frameGraph.addDependency (integrate, renderPrep);
+    }
 
+    // telemetry encodes the integrated states alongside render prep
+    if (! telemetryPath.empty ())
+    {
+        TelemetryWriter::Options options;
+        if (telemetryQuantized) options.format = Telemetry::quantized;
+        if (telemetry.open (telemetryPath, options))
+        {
+            const FrameGraph::Phase record = frameGraph.addPhase ("telemetry", [] ()
+            {
+                writeTelemetry ();
+            });
+            frameGraph.addDependency (integrate, record);
+        }
+    }
 
-    selectedVehicle = NULL;
-    MpObj.open ();
+    // sized for twice the starting population, frames beyond that are
+    // clipped
+    if (! shareName.empty ())
+    {
+        const uint32_t capacity =
+            std::max ((uint32_t) 1024, (uint32_t) MpObj.vehicles().size () * 2);
+        if (share.open (shareName, capacity))
+        {
+            const FrameGraph::Phase publish = frameGraph.addPhase ("share", [] ()
+            {
+                publishSharedState ();
+            });
+            frameGraph.addDependency (integrate, publish);
+        }
+    }
+
+    if (! controlPath.empty () && control.open (controlPath))
+    {
+        const FrameGraph::Phase publish = frameGraph.addPhase ("control", [] ()
+        {
+            publishControlSnapshot ();
+        });
+        frameGraph.addDependency (integrate, publish);
+    }
+
+    // vehicles' random streams derive from this, see Random.h
+    inputLog.setSeed (randomSeed ());
+}
+
+
+bool
+OpenSteer::loadScenario (const char* path)
+{
+    if (! scenario.load (path)) return false;
+
+    MpObj.configure (scenario);
+    world_size = scenario.worldSize;
+    offset = (float)world_size/2;
+    multi = scenario.multi;
+    elapsedTime = scenario.elapsedTime;
+    runFrames = scenario.frames;
+    if (scenario.hasSeed) setRandomSeed (scenario.seed);
+    return true;
+}
+
+
+void
+OpenSteer::runBatch (const size_t worlds, const int threads)
+{
+    // without a scenario run length, step each world for 1000 frames
+    const uint32_t frames = runFrames ? runFrames : 1000;
+    const uint64_t baseSeed = randomSeed ();
+
+    // each world is built, stepped and destroyed by one task, so it lives
+    // on one (pinned) thread for its whole lifetime
+    BatchRunner runner (threads);
+    const BatchRunner::Report report = runner.run (worlds, [&] (size_t i)
+    {
+        MpWorld world;
+        world.configure (scenario);
+        world.setSeed (baseSeed + i);
+        world.setPublishMetrics (false);
+        world.open ();
+        for (uint32_t f = 0; f < frames; f++)
+            world.update_enemies (elapsedTime);
+        Metrics::standard().frames.add (frames);
+        Metrics::standard().steps.add (world.agentSteps ());
+        return world.agentSteps ();
+    });
+
+    std::cout << "batch: " << worlds << " worlds of "
+              << scenario.pursuerCount () << " pursuers, " << frames
+              << " frames each" << std::endl;
+    BatchRunner::printReport (std::cout, report, "agent steps");
+}
+
+
+void
+OpenSteer::setWorkerThreads (const int threads, const bool pin)
+{
+    workerThreads = threads;
+    pinWorkers = pin;
+}
+
+
+void
+OpenSteer::setTelemetryFile (const char* path, const bool quantized)
+{
+    telemetryPath = path;
+    telemetryQuantized = quantized;
+}
+
+
+void
+OpenSteer::setSharedStateName (const char* name)
+{
+    shareName = name;
+}
+
+
+void
+OpenSteer::setControlSocket (const char* path)
+{
+    controlPath = path;
+}
+
+
+void
+OpenSteer::setInputRecordFile (const char* path)
+{
+    inputRecordPath = path;
+}
+
+
+bool
+OpenSteer::replay (const char* path)
+{
+    if (! inputLog.read (path)) return false;
+
+    // recreate the recorded session's world: same seed, same vehicles
+    setRandomSeed (inputLog.seed ());
+    initializeWorld (false);
+
+    // run every recorded frame headlessly at full speed, applying each
+    // input event after the step of the frame it was recorded on
+    const std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now ();
+    size_t next = 0;
+    const std::vector<InputLog::Event>& events = inputLog.events;
+    for (frameIndex = 0; frameIndex < inputLog.frameCount (); frameIndex++)
+    {
+        Metrics::standard().frames.increment ();
+        OPENSTEER_PROFILE_FRAME ();
+        simulationStep ();
+        while (next < events.size () && events[next].frame <= frameIndex)
+            applyInputEvent (events[next++]);
+    }
+    const double seconds = std::chrono::duration<double>
+        (std::chrono::steady_clock::now () - start).count ();
+
+    std::cout << "replayed " << inputLog.frameCount () << " frames, "
+              << events.size () << " input events in " << seconds
+              << " seconds (" << (inputLog.frameCount () / seconds)
+              << " frames per second), trajectory checksum " << std::hex
+              << trajectoryChecksum () << std::dec << std::endl;
+    closeTelemetry ();
+    share.close ();
+    control.close ();
+    MpObj.printLodReport (std::cout);
+    scheduler->printReport (std::cout);
+    OPENSTEER_PROFILE_REPORT (std::cout);
+
+    MpObj.close ();
+    return true;
+}
+
+void
+OpenSteer::OpenSteerDemo::initialize (void)
+{
+    initializeWorld (true);
 
     //set the callback function for any mouse event
     cv::namedWindow("Window", 1);
@@ -0,0 +1,395 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// OrcaSolver: reciprocal collision avoidance (ORCA) for crowds of agents
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#include "OpenSteer/OrcaSolver.h"
+#include "OpenSteer/Profile.h"
+
+#include <algorithm>
+#include <math.h>
+#include <utility>
+#include <vector>
+
+
+namespace {
+
+    // vectors on the XZ plane: x is x, y is z
+    struct V2
+    {
+        float x, y;
+
+        V2 (void) : x (0), y (0) {}
+        V2 (const float _x, const float _y) : x (_x), y (_y) {}
+        explicit V2 (const OpenSteer::Vec3& v) : x (v.x), y (v.z) {}
+
+        V2 operator+ (const V2& v) const {return V2 (x + v.x, y + v.y);}
+        V2 operator- (const V2& v) const {return V2 (x - v.x, y - v.y);}
+        V2 operator- (void) const {return V2 (-x, -y);}
+        V2 operator* (const float s) const {return V2 (x * s, y * s);}
+        V2 operator/ (const float s) const {return V2 (x / s, y / s);}
+    };
+
+    float dot (const V2& a, const V2& b) {return a.x * b.x + a.y * b.y;}
+    float det (const V2& a, const V2& b) {return a.x * b.y - a.y * b.x;}
+    float lengthSquared (const V2& a) {return dot (a, a);}
+    V2 normalize (const V2& a) {return a / sqrtf (lengthSquared (a));}
+
+    const float epsilon = 0.00001f;
+
+    // the velocities allowed by one neighbor: left of direction through
+    // point
+    struct Line
+    {
+        V2 point;
+        V2 direction;
+    };
+
+    // per thread scratch, reused from agent to agent
+    struct Scratch
+    {
+        std::vector<std::pair<float, int> > nearest;
+        std::vector<Line> lines;
+        std::vector<Line> projected;
+    };
+
+    thread_local Scratch scratch;
+
+
+    // optimize along line "current" subject to lines [0, current) and the
+    // speed limit circle.  False if infeasible.
+    bool linearProgram1 (const std::vector<Line>& lines,
+                         const size_t current,
+                         const float radius,
+                         const V2& optimum,
+                         const bool directionOpt,
+                         V2& result)
+    {
+        const Line& line = lines[current];
+        const float dotProduct = dot (line.point, line.direction);
+        const float discriminant = dotProduct * dotProduct + radius * radius -
+                                   lengthSquared (line.point);
+
+        // the speed limit circle excludes the whole line
+        if (discriminant < 0) return false;
+
+        const float sqrtDiscriminant = sqrtf (discriminant);
+        float tLeft = -dotProduct - sqrtDiscriminant;
+        float tRight = -dotProduct + sqrtDiscriminant;
+
+        for (size_t i = 0; i < current; i++)
+        {
+            const float denominator = det (line.direction, lines[i].direction);
+            const float numerator = det (lines[i].direction,
+                                         line.point - lines[i].point);
+
+            // parallel lines: either no constraint here or infeasible
+            if (fabsf (denominator) <= epsilon)
+            {
+                if (numerator < 0) return false;
+                continue;
+            }
+
+            const float t = numerator / denominator;
+            if (denominator >= 0) tRight = std::min (tRight, t);
+            else tLeft = std::max (tLeft, t);
+            if (tLeft > tRight) return false;
+        }
+
+        if (directionOpt)
+        {
+            // optimize direction: take the far end along it
+            result = line.point +
+                line.direction * (dot (optimum, line.direction) > 0 ?
+                                  tRight : tLeft);
+        }
+        else
+        {
+            // optimize closest point
+            const float t = dot (line.direction, optimum - line.point);
+            result = line.point +
+                line.direction * std::min (tRight, std::max (tLeft, t));
+        }
+        return true;
+    }
+
+
+    // velocity closest to optimum (or furthest along it, with directionOpt)
+    // satisfying all lines and the speed limit.  Returns the number of
+    // lines, or the index of the first line that could not be satisfied.
+    size_t linearProgram2 (const std::vector<Line>& lines,
+                           const float radius,
+                           const V2& optimum,
+                           const bool directionOpt,
+                           V2& result)
+    {
+        if (directionOpt)
+            result = optimum * radius;
+        else if (lengthSquared (optimum) > radius * radius)
+            result = normalize (optimum) * radius;
+        else
+            result = optimum;
+
+        for (size_t i = 0; i < lines.size (); i++)
+        {
+            // result violates line i: move onto it
+            if (det (lines[i].direction, lines[i].point - result) > 0)
+            {
+                const V2 previous = result;
+                if (! linearProgram1 (lines, i, radius, optimum,
+                                      directionOpt, result))
+                {
+                    result = previous;
+                    return i;
+                }
+            }
+        }
+        return lines.size ();
+    }
+
+
+    // infeasible: minimize the largest violation over lines [begin, end),
+    // a 3D linear program solved as a sequence of 2D ones
+    void linearProgram3 (const std::vector<Line>& lines,
+                         const size_t begin,
+                         const float radius,
+                         V2& result,
+                         std::vector<Line>& projected)
+    {
+        float distance = 0;
+        for (size_t i = begin; i < lines.size (); i++)
+        {
+            if (det (lines[i].direction, lines[i].point - result) <= distance)
+                continue;
+
+            // constraints of the previous lines, projected onto line i
+            projected.clear ();
+            for (size_t j = 0; j < i; j++)
+            {
+                Line line;
+                const float determinant = det (lines[i].direction,
+                                               lines[j].direction);
+                if (fabsf (determinant) <= epsilon)
+                {
+                    // parallel: same direction adds nothing
+                    if (dot (lines[i].direction, lines[j].direction) > 0)
+                        continue;
+                    line.point = (lines[i].point + lines[j].point) * 0.5f;
+                }
+                else
+                {
+                    line.point = lines[i].point + lines[i].direction *
+                        (det (lines[j].direction,
+                              lines[i].point - lines[j].point) / determinant);
+                }
+                line.direction = normalize (lines[j].direction -
+                                            lines[i].direction);
+                projected.push_back (line);
+            }
+
+            const V2 previous = result;
+            const V2 outward (-lines[i].direction.y, lines[i].direction.x);
+            if (linearProgram2 (projected, radius, outward, true, result) <
+                projected.size ())
+            {
+                // can only happen through floating point error: keep the
+                // previous result
+                result = previous;
+            }
+            distance = det (lines[i].direction, lines[i].point - result);
+        }
+    }
+
+} // anonymous namespace
+
+
+// ----------------------------------------------------------------------------
+
+
+void 
+OpenSteer::OrcaSolver::solve (const Agents& agents,
+                              const size_t* active,
+                              const size_t activeCount,
+                              const float* elapsedTime,
+                              Vec3* newVelocity,
+                              TaskScheduler* scheduler)
+{
+    OPENSTEER_PROFILE_ZONE ("orca");
+    if (agents.count == 0) return;
+
+    {
+        // cells a few agents wide: the nearest neighbor search then
+        // visits few cells, and few points in each, even in dense crowds
+        OPENSTEER_PROFILE_ZONE ("orcaIndex");
+        float maxRadius = 0;
+        for (size_t i = 0; i < agents.count; i++)
+            maxRadius = std::max (maxRadius, agents.radius[i]);
+        grid.rebuild (agents.position, agents.count,
+                      std::min (options.neighborDistance, 4 * maxRadius));
+    }
+
+    // solve the agents cell by cell, so consecutive agents share most of
+    // their neighbors and grid cells in cache
+    {
+        OPENSTEER_PROFILE_ZONE ("orcaOrder");
+        slot.assign (agents.count, -1);
+        for (size_t k = 0; k < activeCount; k++)
+            slot[active ? active[k] : k] = (int) k;
+        order.clear ();
+        const std::vector<int>& points = grid.cellOrder ();
+        for (size_t p = 0; p < points.size (); p++)
+            if (slot[points[p]] >= 0) order.push_back (slot[points[p]]);
+    }
+
+    const TaskScheduler::RangeTask body =
+        [&, this] (size_t begin, size_t end)
+    {
+        for (size_t o = begin; o < end; o++)
+        {
+            const size_t k = order[o];
+            const size_t i = active ? active[k] : k;
+            newVelocity[k] = solveAgent (agents, i, elapsedTime[k]);
+        }
+    };
+    if (scheduler) scheduler->parallelFor (0, order.size (), 256, body,
+                                           "orcaAgents");
+    else body (0, order.size ());
+}
+
+
+OpenSteer::Vec3 
+OpenSteer::OrcaSolver::solveAgent (const Agents& agents,
+                                   const size_t i,
+                                   const float elapsedTime) const
+{
+    const V2 position (agents.position[i]);
+    const V2 velocity (agents.velocity[i]);
+    const V2 preferred (agents.preferred[i]);
+    const float radius = agents.radius[i];
+    const float maxSpeed = agents.maxSpeed[i];
+
+    // the nearest maxNeighbors others within neighborDistance (asking for
+    // one more, which is usually i itself)
+    Scratch& s = scratch;
+    grid.queryNearest (agents.position[i], options.maxNeighbors + 1,
+                       options.neighborDistance, s.nearest);
+    for (size_t n = 0; n < s.nearest.size (); n++)
+    {
+        if (s.nearest[n].second != (int) i) continue;
+        s.nearest.erase (s.nearest.begin () + n);
+        break;
+    }
+    const size_t neighbors = std::min (s.nearest.size (),
+                                       (size_t) options.maxNeighbors);
+
+    // one half plane of permitted velocities per neighbor
+    const float invTimeHorizon = 1 / options.timeHorizon;
+    s.lines.clear ();
+    for (size_t n = 0; n < neighbors; n++)
+    {
+        const int j = s.nearest[n].second;
+        const V2 relativePosition = V2 (agents.position[j]) - position;
+        const V2 relativeVelocity = velocity - V2 (agents.velocity[j]);
+        const float distanceSquared = s.nearest[n].first;
+        const float combinedRadius = radius + agents.radius[j];
+        const float combinedRadiusSquared = combinedRadius * combinedRadius;
+
+        Line line;
+        V2 u;
+        if (distanceSquared > combinedRadiusSquared)
+        {
+            // no collision yet.  w: from the cutoff circle's center to the
+            // relative velocity
+            const V2 w = relativeVelocity - relativePosition * invTimeHorizon;
+            const float wLengthSquared = lengthSquared (w);
+            const float dotProduct = dot (w, relativePosition);
+
+            if (dotProduct < 0 &&
+                dotProduct * dotProduct > combinedRadiusSquared * wLengthSquared)
+            {
+                // project on the cutoff circle
+                const float wLength = sqrtf (wLengthSquared);
+                const V2 unitW = w / wLength;
+                line.direction = V2 (unitW.y, -unitW.x);
+                u = unitW * (combinedRadius * invTimeHorizon - wLength);
+            }
+            else
+            {
+                // project on the nearer leg of the cone
+                const float leg = sqrtf (distanceSquared - combinedRadiusSquared);
+                if (det (relativePosition, w) > 0)
+                {
+                    line.direction = V2 (relativePosition.x * leg -
+                                         relativePosition.y * combinedRadius,
+                                         relativePosition.x * combinedRadius +
+                                         relativePosition.y * leg) /
+                                     distanceSquared;
+                }
+                else
+                {
+                    line.direction = -V2 (relativePosition.x * leg +
+                                          relativePosition.y * combinedRadius,
+                                          -relativePosition.x * combinedRadius +
+                                          relativePosition.y * leg) /
+                                     distanceSquared;
+                }
+                u = line.direction * dot (relativeVelocity, line.direction) -
+                    relativeVelocity;
+            }
+        }
+        else
+        {
+            // already overlapping: get apart within this time step
+            const float invTimeStep = 1 / elapsedTime;
+            const V2 w = relativeVelocity - relativePosition * invTimeStep;
+            const float wLength = sqrtf (lengthSquared (w));
+            const V2 unitW = wLength > 0 ? w / wLength : V2 (1, 0);
+            line.direction = V2 (unitW.y, -unitW.x);
+            u = unitW * (combinedRadius * invTimeStep - wLength);
+        }
+
+        // take half the responsibility for avoiding
+        line.point = velocity + u * 0.5f;
+        s.lines.push_back (line);
+    }
+
+    V2 result;
+    const size_t failed = linearProgram2 (s.lines, maxSpeed, preferred,
+                                          false, result);
+    if (failed < s.lines.size ())
+        linearProgram3 (s.lines, failed, maxSpeed, result, s.projected);
+    return Vec3 (result.x, 0, result.y);
+}
+
+
+// ----------------------------------------------------------------------------
@@ -0,0 +1,351 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// Profile: scoped timing zones for hot paths
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#include "OpenSteer/Profile.h"
+
+
+#ifdef OPENSTEER_PROFILE
+
+
+#include "OpenSteer/Histogram.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace {
+
+    // zone name registry, ids are indices
+    const int maxZones = 256;
+    const char* zoneNames[maxZones];
+    int zoneNameCount = 0;
+
+    // every thread's ring, in order of creation (never freed, so samples
+    // from threads which have exited remain available to reports)
+    std::vector<OpenSteer::ProfileRing*> rings;
+
+    // guards both of the above (not taken on the recording path)
+    std::mutex registryMutex;
+
+    thread_local OpenSteer::ProfileRing* currentThreadRing = 0;
+
+    // trace capture state.  The buffer is allocated by captureTrace, before
+    // the window opens, and only read by frameMark after it has closed and
+    // traceWriters (threads inside traceRecord) has dropped to zero.
+    std::vector<OpenSteer::ProfileSample> traceBuffer;
+    std::atomic<int> traceCount (0);
+    std::atomic<int> traceWriters (0);
+    std::string tracePath;
+    int traceFramesRequested = 0;  // length of the armed/open window
+    int traceFramesRemaining = 0;  // frames left in the open window
+    bool traceArmed = false;       // waiting for the next frame to start
+    int64_t traceStart = 0;
+
+} // anonymous namespace
+
+
+std::atomic<bool> OpenSteer::Profiler::traceActive (false);
+
+
+// ----------------------------------------------------------------------------
+// ProfileRing
+
+
+OpenSteer::ProfileRing::ProfileRing (const uint32_t threadNumber)
+    : thread (threadNumber), depth (0), head (0)
+{
+}
+
+
+// ----------------------------------------------------------------------------
+// zone registry
+
+
+int 
+OpenSteer::Profiler::registerZone (const char* name)
+{
+    std::lock_guard<std::mutex> lock (registryMutex);
+
+    // the same name used at several call sites shares one zone
+    for (int i = 0; i < zoneNameCount; i++)
+        if (std::strcmp (zoneNames[i], name) == 0) return i;
+
+    if (zoneNameCount == maxZones)
+    {
+        std::cerr << "Profiler: too many zones, \"" << name
+                  << "\" merged into \"" << zoneNames[maxZones - 1] << "\""
+                  << std::endl;
+        return maxZones - 1;
+    }
+
+    zoneNames[zoneNameCount] = name;
+    return zoneNameCount++;
+}
+
+
+const char* 
+OpenSteer::Profiler::zoneName (const int id)
+{
+    std::lock_guard<std::mutex> lock (registryMutex);
+    return (id < zoneNameCount) ? zoneNames[id] : "?";
+}
+
+
+int 
+OpenSteer::Profiler::zoneCount (void)
+{
+    std::lock_guard<std::mutex> lock (registryMutex);
+    return zoneNameCount;
+}
+
+
+// ----------------------------------------------------------------------------
+// per-thread rings
+
+
+OpenSteer::ProfileRing& 
+OpenSteer::Profiler::threadRing (void)
+{
+    if (currentThreadRing == 0)
+    {
+        std::lock_guard<std::mutex> lock (registryMutex);
+        currentThreadRing = new ProfileRing ((uint32_t) rings.size ());
+        rings.push_back (currentThreadRing);
+    }
+    return *currentThreadRing;
+}
+
+
+int 
+OpenSteer::Profiler::ringCount (void)
+{
+    std::lock_guard<std::mutex> lock (registryMutex);
+    return (int) rings.size ();
+}
+
+
+OpenSteer::ProfileRing* 
+OpenSteer::Profiler::ring (const int i)
+{
+    std::lock_guard<std::mutex> lock (registryMutex);
+    return rings[i];
+}
+
+
+void 
+OpenSteer::Profiler::clear (void)
+{
+    std::lock_guard<std::mutex> lock (registryMutex);
+    for (size_t i = 0; i < rings.size (); i++) rings[i]->clear ();
+}
+
+
+// ----------------------------------------------------------------------------
+// print per-zone min/mean/max/percentile table (times in microseconds)
+
+
+namespace {
+
+    class ZoneAccumulator
+    {
+    public:
+        ZoneAccumulator (const int zones) : histograms (zones) {}
+        void operator() (const OpenSteer::ProfileRing& r)
+        {
+            for (int i = 0; i < r.size (); i++)
+            {
+                const OpenSteer::ProfileSample& s = r.at (i);
+                if (s.zone < histograms.size ())
+                    histograms[s.zone].record (s.end - s.start);
+            }
+        }
+        std::vector<OpenSteer::Histogram> histograms;
+    };
+
+} // anonymous namespace
+
+
+void 
+OpenSteer::Profiler::printReport (std::ostream& o)
+{
+    const int zones = zoneCount ();
+    ZoneAccumulator accumulator (zones);
+    forEachRing (accumulator);
+
+    o << std::fixed << std::setprecision (3)
+      << "zone (us)                count       min      mean"
+      << "       p50       p99      p999       max" << std::endl;
+    for (int z = 0; z < zones; z++)
+    {
+        const Histogram& h = accumulator.histograms[z];
+        if (h.count () == 0) continue;
+        o << std::setw (20) << std::left << zoneName (z) << std::right
+          << std::setw (10) << h.count ()
+          << std::setw (10) << h.min () / 1.0e3
+          << std::setw (10) << h.mean () / 1.0e3
+          << std::setw (10) << h.valueAtPercentile (50.0) / 1.0e3
+          << std::setw (10) << h.valueAtPercentile (99.0) / 1.0e3
+          << std::setw (10) << h.valueAtPercentile (99.9) / 1.0e3
+          << std::setw (10) << h.max () / 1.0e3
+          << std::endl;
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+// Chrome trace capture
+
+
+bool 
+OpenSteer::Profiler::captureTrace (const int frames,
+                                   const std::string& path,
+                                   const int maxEvents)
+{
+    if (traceArmed || tracing () || (frames <= 0)) return false;
+
+    // allocate (and touch) the whole buffer up front, outside the window
+    traceBuffer.assign (maxEvents, ProfileSample ());
+    traceCount.store (0, std::memory_order_relaxed);
+    tracePath = path;
+    traceFramesRequested = frames;
+    traceArmed = true;
+    return true;
+}
+
+
+void 
+OpenSteer::Profiler::traceRecord (const ProfileSample& s)
+{
+    // announce ourselves before checking the window (both sequentially
+    // consistent): either frameMark sees us and waits, or we see the
+    // window closed and leave the buffer alone
+    traceWriters.fetch_add (1);
+    if (traceActive.load ())
+    {
+        const int i = traceCount.fetch_add (1, std::memory_order_relaxed);
+        if (i < (int) traceBuffer.size ()) traceBuffer[i] = s;
+    }
+    traceWriters.fetch_sub (1, std::memory_order_release);
+}
+
+
+void 
+OpenSteer::Profiler::frameMark (void)
+{
+    if (traceArmed)
+    {
+        // open the window at this frame boundary
+        traceArmed = false;
+        traceFramesRemaining = traceFramesRequested;
+        traceStart = now ();
+        traceActive.store (true, std::memory_order_release);
+    }
+    else if (tracing () && (--traceFramesRemaining <= 0))
+    {
+        // close the window, wait for threads still appending a zone, then
+        // write out what it captured
+        traceActive.store (false);
+        while (traceWriters.load (std::memory_order_acquire) != 0)
+            std::this_thread::yield ();
+        writeTrace ();
+    }
+}
+
+
+// write the trace buffer as Chrome trace-event JSON: one "complete" (ph X)
+// event per zone, timestamps in microseconds relative to the window start,
+// one track per profiled thread
+
+
+void 
+OpenSteer::Profiler::writeTrace (void)
+{
+    const int recorded = traceCount.load (std::memory_order_acquire);
+    const int kept = std::min (recorded, (int) traceBuffer.size ());
+
+    std::ofstream o (tracePath.c_str ());
+    if (!o)
+    {
+        std::cerr << "Profiler: cannot write trace file " << tracePath
+                  << std::endl;
+        return;
+    }
+
+    o << std::fixed << std::setprecision (3)
+      << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[" << std::endl;
+
+    // name each thread's track
+    const int threads = ringCount ();
+    for (int t = 0; t < threads; t++)
+    {
+        o << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << t
+          << ",\"args\":{\"name\":\"thread " << t << "\"}}," << std::endl;
+    }
+
+    for (int i = 0; i < kept; i++)
+    {
+        const ProfileSample& s = traceBuffer[i];
+        o << "{\"name\":\"" << zoneName (s.zone)
+          << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << s.thread
+          << ",\"ts\":" << (s.start - traceStart) / 1.0e3
+          << ",\"dur\":" << (s.end - s.start) / 1.0e3
+          << "}," << std::endl;
+    }
+
+    // trailing metadata event avoids a dangling comma
+    o << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1"
+      << ",\"args\":{\"name\":\"OpenSteer\"}}" << std::endl
+      << "]}" << std::endl;
+
+    std::cout << "Profiler: wrote " << kept << " trace events to "
+              << tracePath;
+    if (recorded > kept)
+        std::cout << " (" << recorded - kept << " dropped, buffer full)";
+    std::cout << std::endl;
+
+    // release the buffer
+    std::vector<ProfileSample> ().swap (traceBuffer);
+}
+
+
+#endif // OPENSTEER_PROFILE
+
+
+// ----------------------------------------------------------------------------
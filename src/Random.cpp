@@ -0,0 +1,90 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// Random: seedable, fast pseudo-random number streams
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#include "OpenSteer/Random.h"
+
+#include <atomic>
+
+
+namespace {
+
+    std::atomic<uint64_t> globalSeed (0);
+
+    // bumped by setRandomSeed so per-thread streams know to reseed
+    std::atomic<uint32_t> seedGeneration (1);
+
+    // threads are numbered in order of first use of threadRandomStream
+    std::atomic<uint64_t> nextThreadNumber (0);
+
+    // per-thread stream state.  Thread streams use stream numbers from the
+    // top of the range so they never coincide with per-agent streams.
+    thread_local OpenSteer::RandomStream threadStream;
+    thread_local uint32_t threadGeneration = 0;
+    thread_local uint64_t threadNumber = 0;
+
+} // anonymous namespace
+
+
+uint64_t 
+OpenSteer::randomSeed (void)
+{
+    return globalSeed.load (std::memory_order_relaxed);
+}
+
+
+void 
+OpenSteer::setRandomSeed (const uint64_t seed)
+{
+    globalSeed.store (seed, std::memory_order_relaxed);
+    seedGeneration.fetch_add (1, std::memory_order_release);
+}
+
+
+OpenSteer::RandomStream& 
+OpenSteer::threadRandomStream (void)
+{
+    const uint32_t generation = seedGeneration.load (std::memory_order_acquire);
+    if (threadGeneration != generation)
+    {
+        if (threadGeneration == 0)
+            threadNumber = nextThreadNumber.fetch_add (1);
+        threadGeneration = generation;
+        threadStream.setSeed (randomSeed (), ~threadNumber);
+    }
+    return threadStream;
+}
+
+
+// ----------------------------------------------------------------------------
@@ -0,0 +1,237 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// Scenario: run configuration loaded from a text file
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#include "OpenSteer/Scenario.h"
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <utility>
+
+
+namespace {
+
+    template <class T>
+    bool readValue (std::istream& in, T& value)
+    {
+        return ! (in >> value).fail ();
+    }
+
+    // read a value no less than minimum
+    template <class T>
+    bool readAtLeast (std::istream& in, T& value, const T minimum)
+    {
+        return readValue (in, value) && value >= minimum;
+    }
+
+    // read a value greater than zero
+    template <class T>
+    bool readPositive (std::istream& in, T& value)
+    {
+        return readValue (in, value) && value > 0;
+    }
+
+    // read a count that fits in a uint32_t (a plain read of "-1" would
+    // wrap around)
+    bool readCount (std::istream& in, uint32_t& value)
+    {
+        long long n;
+        if (! readValue (in, n) || n < 0 || n > 0xffffffffLL) return false;
+        value = (uint32_t) n;
+        return true;
+    }
+
+    bool badValue (const std::string& path,
+                   const int lineNumber,
+                   const std::string& key)
+    {
+        std::cerr << "Scenario: " << path << ":" << lineNumber
+                  << ": bad value for \"" << key << "\"" << std::endl;
+        return false;
+    }
+
+} // anonymous namespace
+
+
+// ----------------------------------------------------------------------------
+
+
+OpenSteer::Scenario::Population::Population (void)
+    : name ("pursuers"),
+      count (8),
+      maxForce (5),
+      maxSpeed (3),
+      spawnInner (20),
+      spawnOuter (30)
+{
+}
+
+
+OpenSteer::Scenario::Scenario (void)
+    : worldSize (1000),
+      multi (20),
+      elapsedTime (0.006f),
+      frames (0),
+      hasSeed (false),
+      seed (0),
+      wanderers (1),
+      wandererSpread (40),
+      reassignFrames (8),
+      populations (1)
+{
+}
+
+
+int 
+OpenSteer::Scenario::pursuerCount (void) const
+{
+    int n = 0;
+    for (size_t i = 0; i < populations.size (); i++) n += populations[i].count;
+    return n;
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+bool 
+OpenSteer::Scenario::load (const std::string& path)
+{
+    std::ifstream in (path.c_str ());
+    if (!in)
+    {
+        std::cerr << "Scenario: " << path << ": cannot open" << std::endl;
+        return false;
+    }
+
+    Scenario s;
+    s.populations.clear ();
+
+    // where each population's spawn ring was last set (line and key),
+    // checked once the whole population is read
+    std::vector<std::pair<int, std::string> > ringLines;
+
+    std::string line;
+    for (int lineNumber = 1; std::getline (in, line); lineNumber++)
+    {
+        const std::string::size_type comment = line.find ('#');
+        if (comment != std::string::npos) line.erase (comment);
+
+        std::istringstream fields (line);
+        std::string key;
+        if (! readValue (fields, key)) continue;
+
+        Population* p = s.populations.empty () ? 0 : &s.populations.back ();
+        bool ok;
+        if (key == "population")
+        {
+            s.populations.push_back (Population ());
+            ringLines.push_back (std::make_pair (lineNumber, key));
+            ok = readValue (fields, s.populations.back().name);
+        }
+        else if (key == "world_size")   ok = readPositive (fields, s.worldSize);
+        else if (key == "multi")        ok = readPositive (fields, s.multi);
+        else if (key == "elapsed_time") ok = readPositive (fields, s.elapsedTime);
+        else if (key == "frames")       ok = readCount (fields, s.frames);
+        else if (key == "seed")         ok = s.hasSeed = readValue (fields, s.seed);
+        else if (key == "wanderers")    ok = readPositive (fields, s.wanderers);
+        else if (key == "wanderer_spread") ok = readAtLeast (fields, s.wandererSpread, 0.0f);
+        else if (key == "reassign_frames") ok = readPositive (fields, s.reassignFrames);
+        else if (key == "sleep_frames") ok = readAtLeast (fields, s.sleep.frames, 0);
+        else if (key == "sleep_force")  ok = readAtLeast (fields, s.sleep.force, 0.0f);
+        else if (key == "sleep_speed")  ok = readAtLeast (fields, s.sleep.speed, 0.0f);
+        else if (key == "wake_radius")  ok = readAtLeast (fields, s.sleep.wakeRadius, 0.0f);
+        else if (key == "avoid_neighbors") ok = readAtLeast (fields, s.avoidance.maxNeighbors, 0);
+        else if (key == "avoid_distance") ok = readPositive (fields, s.avoidance.neighborDistance);
+        else if (key == "avoid_horizon") ok = readPositive (fields, s.avoidance.timeHorizon);
+        else if (key == "lod_tier")
+        {
+            // tiers in order of increasing distance
+            LodScheduler::Tier t;
+            ok = (readPositive (fields, t.maxDistance) &&
+                  readPositive (fields, t.period) &&
+                  (s.lodTiers.empty () ||
+                   t.maxDistance > s.lodTiers.back().maxDistance));
+            s.lodTiers.push_back (t);
+        }
+        else if (p && key == "count")       ok = readAtLeast (fields, p->count, 0);
+        else if (p && key == "max_force")   ok = readAtLeast (fields, p->maxForce, 0.0f);
+        else if (p && key == "max_speed")   ok = readAtLeast (fields, p->maxSpeed, 0.0f);
+        else if (p && key == "spawn_inner")
+        {
+            ok = readAtLeast (fields, p->spawnInner, 0.0f);
+            ringLines.back () = std::make_pair (lineNumber, key);
+        }
+        else if (p && key == "spawn_outer")
+        {
+            ok = readAtLeast (fields, p->spawnOuter, 0.0f);
+            ringLines.back () = std::make_pair (lineNumber, key);
+        }
+        else
+        {
+            std::cerr << "Scenario: " << path << ":" << lineNumber
+                      << ": unknown key \"" << key << "\"" << std::endl;
+            return false;
+        }
+
+        if (! ok) return badValue (path, lineNumber, key);
+    }
+
+    if (s.populations.empty ())
+    {
+        std::cerr << "Scenario: " << path << ": no population" << std::endl;
+        return false;
+    }
+
+    long long total = 0;
+    for (size_t i = 0; i < s.populations.size (); i++)
+    {
+        const Population& p = s.populations[i];
+        if (p.spawnInner > p.spawnOuter)
+            return badValue (path, ringLines[i].first, ringLines[i].second);
+        total += p.count;
+    }
+    if (total > 0x7fffffff)
+    {
+        std::cerr << "Scenario: " << path << ": too many pursuers" << std::endl;
+        return false;
+    }
+
+    *this = s;
+    return true;
+}
+
+
+// ----------------------------------------------------------------------------
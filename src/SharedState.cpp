@@ -0,0 +1,325 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// SharedState: agent arrays published in POSIX shared memory for viewers
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#include "OpenSteer/SharedState.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <iostream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+namespace {
+
+    // segment layout: this header, then two buffers, each a BufferHeader
+    // followed by the six arrays.  Every part starts on a cache line.
+    struct SegmentHeader
+    {
+        char magic[8];                  // "OSSHARE" padded with a zero
+        uint32_t version;               // SharedState::version
+        uint32_t capacity;              // agents per buffer
+        uint64_t bufferBytes;
+        std::atomic<uint32_t> latest;   // most recently published buffer
+    };
+
+    struct BufferHeader
+    {
+        std::atomic<uint64_t> sequence; // odd while being written
+        uint64_t frame;
+        double time;
+        uint32_t count;
+    };
+
+    const size_t line = 64;
+    const char shareMagic[8] = {'O', 'S', 'S', 'H', 'A', 'R', 'E', 0};
+
+    size_t roundUp (const size_t n) {return (n + line - 1) & ~(line - 1);}
+
+    size_t arrayBytes (const uint32_t capacity)
+    {
+        return roundUp (capacity * sizeof (float));
+    }
+
+    size_t bufferBytes (const uint32_t capacity)
+    {
+        return line + 6 * arrayBytes (capacity);
+    }
+
+    // a buffer's header and arrays within a segment
+    BufferHeader& bufferHeader (const unsigned char* segment, const int b)
+    {
+        const SegmentHeader& h = *(const SegmentHeader*) segment;
+        return *(BufferHeader*) (segment + line + b * h.bufferBytes);
+    }
+
+    OpenSteer::SharedState::View bufferView (const unsigned char* segment,
+                                             const int b)
+    {
+        const SegmentHeader& h = *(const SegmentHeader*) segment;
+        unsigned char* base = (unsigned char*)
+            (segment + line + b * h.bufferBytes + line);
+        const size_t stride = arrayBytes (h.capacity);
+
+        OpenSteer::SharedState::View v;
+        v.frame = 0;
+        v.time = 0;
+        v.count = 0;
+        v.capacity = h.capacity;
+        v.id = (uint32_t*) base;
+        v.x = (float*) (base + 1 * stride);
+        v.y = (float*) (base + 2 * stride);
+        v.z = (float*) (base + 3 * stride);
+        v.heading = (float*) (base + 4 * stride);
+        v.speed = (float*) (base + 5 * stride);
+        return v;
+    }
+
+    bool shareError (const std::string& name, const char* problem)
+    {
+        std::cerr << "SharedState: " << name << ": " << problem << std::endl;
+        return false;
+    }
+
+} // anonymous namespace
+
+
+size_t 
+OpenSteer::SharedState::segmentBytes (const uint32_t capacity)
+{
+    return line + 2 * bufferBytes (capacity);
+}
+
+
+// ----------------------------------------------------------------------------
+// SharedStateWriter
+
+
+OpenSteer::SharedStateWriter::SharedStateWriter (void)
+    : segment (0),
+      bytes (0),
+      agentCapacity (0),
+      writing (0)
+{
+}
+
+
+OpenSteer::SharedStateWriter::~SharedStateWriter (void)
+{
+    close ();
+}
+
+
+bool 
+OpenSteer::SharedStateWriter::open (const std::string& name,
+                                    const uint32_t capacity)
+{
+    close ();
+
+    const int fd = shm_open (name.c_str (), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return shareError (name, "can not create segment");
+    bytes = SharedState::segmentBytes (capacity);
+    if (ftruncate (fd, bytes) != 0)
+    {
+        ::close (fd);
+        shm_unlink (name.c_str ());
+        return shareError (name, "can not size segment");
+    }
+    void* m = mmap (0, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close (fd);
+    if (m == MAP_FAILED)
+    {
+        shm_unlink (name.c_str ());
+        return shareError (name, "can not map segment");
+    }
+    segment = (unsigned char*) m;
+    segmentName = name;
+    agentCapacity = capacity;
+
+    // the segment starts zeroed: both buffers empty at sequence 0.  The
+    // magic goes in last so readers don't map a half made segment.
+    SegmentHeader& h = *(SegmentHeader*) segment;
+    h.version = SharedState::version;
+    h.capacity = capacity;
+    h.bufferBytes = bufferBytes (capacity);
+    h.latest.store (0, std::memory_order_relaxed);
+    std::atomic_thread_fence (std::memory_order_release);
+    std::memcpy (h.magic, shareMagic, sizeof (h.magic));
+    writing = 1;
+    return true;
+}
+
+
+void 
+OpenSteer::SharedStateWriter::close (void)
+{
+    if (! segment) return;
+    munmap (segment, bytes);
+    shm_unlink (segmentName.c_str ());
+    segment = 0;
+}
+
+
+OpenSteer::SharedState::View 
+OpenSteer::SharedStateWriter::beginWrite (const uint64_t frame,
+                                          const double time)
+{
+    // write the buffer readers are not directed to, marked odd meanwhile
+    BufferHeader& b = bufferHeader (segment, writing);
+    const uint64_t s = b.sequence.load (std::memory_order_relaxed);
+    b.sequence.store (s + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence (std::memory_order_release);
+    b.frame = frame;
+    b.time = time;
+
+    SharedState::View v = bufferView (segment, writing);
+    v.frame = frame;
+    v.time = time;
+    return v;
+}
+
+
+void 
+OpenSteer::SharedStateWriter::endWrite (const SharedState::View& v,
+                                        const uint32_t count)
+{
+    (void) v;
+    BufferHeader& b = bufferHeader (segment, writing);
+    b.count = std::min (count, agentCapacity);
+    b.sequence.store (b.sequence.load (std::memory_order_relaxed) + 1,
+                      std::memory_order_release);
+
+    // publish it, and write the other one next
+    SegmentHeader& h = *(SegmentHeader*) segment;
+    h.latest.store (writing, std::memory_order_release);
+    writing = 1 - writing;
+}
+
+
+// ----------------------------------------------------------------------------
+// SharedStateReader
+
+
+OpenSteer::SharedStateReader::SharedStateReader (void)
+    : segment (0),
+      bytes (0)
+{
+}
+
+
+OpenSteer::SharedStateReader::~SharedStateReader (void)
+{
+    close ();
+}
+
+
+bool 
+OpenSteer::SharedStateReader::open (const std::string& name)
+{
+    close ();
+
+    const int fd = shm_open (name.c_str (), O_RDONLY, 0);
+    if (fd < 0) return shareError (name, "no such segment");
+    struct stat st;
+    if (fstat (fd, &st) != 0 || (size_t) st.st_size < line)
+    {
+        ::close (fd);
+        return shareError (name, "segment too small");
+    }
+    void* m = mmap (0, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close (fd);
+    if (m == MAP_FAILED) return shareError (name, "can not map segment");
+    segment = (const unsigned char*) m;
+    bytes = st.st_size;
+
+    const SegmentHeader& h = *(const SegmentHeader*) segment;
+    const char* problem = 0;
+    if (std::memcmp (h.magic, shareMagic, sizeof (h.magic)) != 0)
+        problem = "not a SharedState segment";
+    else if (h.version != SharedState::version)
+        problem = "unsupported version";
+    else if (SharedState::segmentBytes (h.capacity) > bytes)
+        problem = "truncated segment";
+    if (problem)
+    {
+        close ();
+        return shareError (name, problem);
+    }
+    return true;
+}
+
+
+void 
+OpenSteer::SharedStateReader::close (void)
+{
+    if (! segment) return;
+    munmap ((void*) segment, bytes);
+    segment = 0;
+}
+
+
+bool 
+OpenSteer::SharedStateReader::beginRead (SharedState::View& v,
+                                         uint64_t& token) const
+{
+    const SegmentHeader& h = *(const SegmentHeader*) segment;
+    const int b = h.latest.load (std::memory_order_acquire);
+    const BufferHeader& buffer = bufferHeader (segment, b);
+    const uint64_t s = buffer.sequence.load (std::memory_order_acquire);
+    if (s & 1) return false;
+
+    v = bufferView (segment, b);
+    v.frame = buffer.frame;
+    v.time = buffer.time;
+    v.count = std::min (buffer.count, v.capacity);
+    token = (s << 1) | b;
+    return true;
+}
+
+
+bool 
+OpenSteer::SharedStateReader::endRead (const uint64_t token) const
+{
+    std::atomic_thread_fence (std::memory_order_acquire);
+    const BufferHeader& buffer = bufferHeader (segment, (int) (token & 1));
+    return buffer.sequence.load (std::memory_order_relaxed) == (token >> 1);
+}
+
+
+// ----------------------------------------------------------------------------
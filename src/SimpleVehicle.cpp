@@ -68,7 +68,7 @@
 // serial numbers  (XXX should this be part of a "OpenSteerDemo vehicle mixin"?)
 
 
-int OpenSteer::SimpleVehicle::serialNumberCounter = 0;
+std::atomic<int> OpenSteer::SimpleVehicle::serialNumberCounter (0);
 
 
 // ----------------------------------------------------------------------------
@@ -77,11 +77,27 @@ int OpenSteer::SimpleVehicle::serialNumberCounter = 0;
 
 OpenSteer::SimpleVehicle::SimpleVehicle (void)
 {
+    // maintain unique serial numbers
+    serialNumber = serialNumberCounter++;
+
+    // each vehicle draws from its own random stream, identified by the
+    // global seed and the vehicle's serial number
+    randomStream().setSeed (randomSeed (), serialNumber);
+
     // set inital state
     reset ();
+}
+
 
+OpenSteer::SimpleVehicle::SimpleVehicle (const State& s)
+{
     // maintain unique serial numbers
     serialNumber = serialNumberCounter++;
+
+    // the steering mixin's defaults, then everything a State holds
+    // (including the random stream)
+    SimpleVehicle_3::reset ();
+    setState (s);
 }
 
 
@@ -94,6 +110,58 @@ OpenSteer::SimpleVehicle::~SimpleVehicle (void)
 }
 
 
+// ----------------------------------------------------------------------------
+// copy complete dynamic state to / from plain data (for snapshots)
+
+
+void 
+OpenSteer::SimpleVehicle::getState (State& s) const
+{
+    s.side = side ();
+    s.up = up ();
+    s.forward = forward ();
+    s.position = position ();
+    s.mass = _mass;
+    s.radius = _radius;
+    s.speed = _speed;
+    s.maxForce = _maxForce;
+    s.maxSpeed = _maxSpeed;
+    s.curvature = _curvature;
+    s.lastForward = _lastForward;
+    s.lastPosition = _lastPosition;
+    s.smoothedPosition = _smoothedPosition;
+    s.smoothedCurvature = _smoothedCurvature;
+    s.smoothedAcceleration = _smoothedAcceleration;
+    s.wanderSide = WanderSide;
+    s.wanderUp = WanderUp;
+    s.random = randomStream().state ();
+}
+
+
+void 
+OpenSteer::SimpleVehicle::setState (const State& s)
+{
+    setSide (s.side);
+    setUp (s.up);
+    setForward (s.forward);
+    setPosition (s.position);
+    _mass = s.mass;
+    _radius = s.radius;
+    _speed = s.speed;
+    _maxForce = s.maxForce;
+    _maxSpeed = s.maxSpeed;
+    _curvature = s.curvature;
+    _lastForward = s.lastForward;
+    _lastPosition = s.lastPosition;
+    _smoothedPosition = s.smoothedPosition;
+    _smoothedCurvature = s.smoothedCurvature;
+    _smoothedAcceleration = s.smoothedAcceleration;
+    WanderSide = s.wanderSide;
+    WanderUp = s.wanderUp;
+    randomStream().setState (s.random);
+}
+
+
 // ----------------------------------------------------------------------------
 // adjust the steering force passed to applySteeringForce.
 //
@@ -0,0 +1,152 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// Snapshot: versioned binary checkpoint of a group of SimpleVehicles
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#include "OpenSteer/Snapshot.h"
+
+#include <cstring>
+#include <fstream>
+
+
+namespace {
+
+    // on-disk header, followed immediately by the State array and then
+    // the Role array
+    struct FileHeader
+    {
+        char magic[8];          // "OSSNAP" padded with zeros
+        uint32_t version;       // Snapshot::version
+        uint32_t stateSize;     // sizeof (SimpleVehicle::State)
+        uint32_t roleSize;      // sizeof (Snapshot::Role)
+        uint32_t padding;
+        OpenSteer::Snapshot::Info info;
+    };
+
+    const char snapshotMagic[8] = {'O', 'S', 'S', 'N', 'A', 'P', 0, 0};
+
+    bool snapshotError (const std::string& path, const char* problem)
+    {
+        std::cerr << "Snapshot: " << path << ": " << problem << std::endl;
+        return false;
+    }
+
+} // anonymous namespace
+
+
+// ----------------------------------------------------------------------------
+
+
+bool 
+OpenSteer::Snapshot::write (const std::string& path,
+                            Info info,
+                            const std::vector<SimpleVehicle::State>& states,
+                            const std::vector<Role>& roles)
+{
+    info.vehicleCount = states.size ();
+    if (info.wandererCount + roles.size () != info.vehicleCount)
+        return snapshotError (path, "not one role per pursuer");
+
+    FileHeader header;
+    std::memset (&header, 0, sizeof (header));
+    std::memcpy (header.magic, snapshotMagic, sizeof (header.magic));
+    header.version = version;
+    header.stateSize = sizeof (SimpleVehicle::State);
+    header.roleSize = sizeof (Role);
+    header.info = info;
+
+    std::ofstream o (path.c_str (), std::ios::binary | std::ios::trunc);
+    if (!o) return snapshotError (path, "cannot open for writing");
+
+    o.write ((const char*) &header, sizeof (header));
+    if (! states.empty ())
+        o.write ((const char*) &states[0],
+                 states.size () * sizeof (SimpleVehicle::State));
+    if (! roles.empty ())
+        o.write ((const char*) &roles[0], roles.size () * sizeof (Role));
+    o.flush ();
+    if (!o) return snapshotError (path, "write failed");
+    return true;
+}
+
+
+bool 
+OpenSteer::Snapshot::read (const std::string& path,
+                           Info& info,
+                           std::vector<SimpleVehicle::State>& states,
+                           std::vector<Role>& roles)
+{
+    std::ifstream in (path.c_str (), std::ios::binary);
+    if (!in) return snapshotError (path, "cannot open for reading");
+
+    FileHeader header;
+    in.read ((char*) &header, sizeof (header));
+    if (!in) return snapshotError (path, "truncated header");
+    if (std::memcmp (header.magic, snapshotMagic, sizeof (header.magic)) != 0)
+        return snapshotError (path, "not a snapshot file");
+    if (header.version != version)
+        return snapshotError (path, "unsupported snapshot version");
+    if (header.stateSize != sizeof (SimpleVehicle::State) ||
+        header.roleSize != sizeof (Role))
+        return snapshotError (path, "vehicle state layout does not match");
+    if (header.info.wandererCount > header.info.vehicleCount)
+        return snapshotError (path, "more wanderers than vehicles");
+
+    // check the counts against the file's length before sizing anything
+    // by them
+    const std::streamoff start = in.tellg ();
+    in.seekg (0, std::ios::end);
+    const uint64_t available = (uint64_t) (in.tellg () - start);
+    in.seekg (start);
+    const uint64_t vehicles = header.info.vehicleCount;
+    const uint64_t pursuers = vehicles - header.info.wandererCount;
+    if (vehicles > available / sizeof (SimpleVehicle::State) ||
+        pursuers * sizeof (Role) >
+        available - vehicles * sizeof (SimpleVehicle::State))
+        return snapshotError (path, "truncated vehicle data");
+
+    states.resize (header.info.vehicleCount);
+    if (! states.empty ())
+        in.read ((char*) &states[0],
+                 states.size () * sizeof (SimpleVehicle::State));
+    roles.resize (header.info.vehicleCount - header.info.wandererCount);
+    if (in && ! roles.empty ())
+        in.read ((char*) &roles[0], roles.size () * sizeof (Role));
+    if (!in) return snapshotError (path, "truncated vehicle data");
+
+    info = header.info;
+    return true;
+}
+
+
+// ----------------------------------------------------------------------------
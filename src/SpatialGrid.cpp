@@ -0,0 +1,260 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// SpatialGrid: uniform grid index over points on the XZ plane
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#include "OpenSteer/SpatialGrid.h"
+#include "OpenSteer/Utilities.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+
+// ----------------------------------------------------------------------------
+
+
+OpenSteer::SpatialGrid::SpatialGrid (void)
+    : cellSize (1),
+      minX (0),
+      minZ (0),
+      columns (0),
+      rows (0)
+{
+}
+
+
+void 
+OpenSteer::SpatialGrid::rebuild (const Vec3* points,
+                                 const size_t count,
+                                 const float size)
+{
+    positions.resize (2 * count);
+    cellPoints.resize (count);
+    if (count == 0)
+    {
+        columns = rows = 0;
+        cellStart.assign (1, 0);
+        return;
+    }
+
+    // bounds of the points
+    float maxX = -FLT_MAX, maxZ = -FLT_MAX;
+    minX = minZ = FLT_MAX;
+    for (size_t i = 0; i < count; i++)
+    {
+        minX = std::min (minX, points[i].x);
+        maxX = std::max (maxX, points[i].x);
+        minZ = std::min (minZ, points[i].z);
+        maxZ = std::max (maxZ, points[i].z);
+    }
+
+    // grow the cells until there are at most about 4 per point
+    const float maxCells = 4.0f * count + 16;
+    cellSize = std::max (size, 1e-6f);
+    while (((maxX - minX) / cellSize + 1) * ((maxZ - minZ) / cellSize + 1)
+           > maxCells)
+        cellSize *= 2;
+    columns = (int) ((maxX - minX) / cellSize) + 1;
+    rows = (int) ((maxZ - minZ) / cellSize) + 1;
+
+    // counting sort of point indices, and their positions, by cell
+    cellStart.assign (columns * rows + 1, 0);
+    for (size_t i = 0; i < count; i++)
+        cellStart[row (points[i].z) * columns + column (points[i].x) + 1]++;
+    for (size_t c = 1; c < cellStart.size (); c++)
+        cellStart[c] += cellStart[c - 1];
+    fill.assign (cellStart.begin (), cellStart.end () - 1);
+    for (size_t i = 0; i < count; i++)
+    {
+        const int c = row (points[i].z) * columns + column (points[i].x);
+        const int k = fill[c]++;
+        cellPoints[k] = (int) i;
+        positions[2*k] = points[i].x;
+        positions[2*k+1] = points[i].z;
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+int 
+OpenSteer::SpatialGrid::column (const float x) const
+{
+    const int c = (int) std::floor ((x - minX) / cellSize);
+    return std::max (0, std::min (columns - 1, c));
+}
+
+
+int 
+OpenSteer::SpatialGrid::row (const float z) const
+{
+    const int r = (int) std::floor ((z - minZ) / cellSize);
+    return std::max (0, std::min (rows - 1, r));
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+int 
+OpenSteer::SpatialGrid::nearest (const Vec3& p) const
+{
+    if (columns == 0) return -1;
+
+    const int pc = column (p.x);
+    const int pr = row (p.z);
+    int best = -1;
+    float bestDistanceSquared = FLT_MAX;
+
+    // visit square rings of cells around p's (clamped) cell.  Every point
+    // beyond ring r is at least r cells away, so stop once the best point
+    // found is nearer than that.
+    const int maxRing = std::max (columns, rows);
+    for (int ring = 0; ring <= maxRing; ring++)
+    {
+        if (best >= 0 &&
+            bestDistanceSquared <= square (ring * cellSize - cellSize))
+            break;
+
+        for (int r = pr - ring; r <= pr + ring; r++)
+        {
+            if (r < 0 || r >= rows) continue;
+            const bool edgeRow = (r == pr - ring) || (r == pr + ring);
+            const int step = edgeRow ? 1 : 2 * ring;
+            for (int c = pc - ring; c <= pc + ring; c += step)
+            {
+                if (c < 0 || c >= columns) continue;
+                const int cell = r * columns + c;
+                for (int k = cellStart[cell]; k < cellStart[cell + 1]; k++)
+                {
+                    const float dx = positions[2*k] - p.x;
+                    const float dz = positions[2*k+1] - p.z;
+                    const float d = dx * dx + dz * dz;
+                    if (d < bestDistanceSquared)
+                    {
+                        bestDistanceSquared = d;
+                        best = cellPoints[k];
+                    }
+                }
+            }
+        }
+    }
+    return best;
+}
+
+
+void 
+OpenSteer::SpatialGrid::queryRadius (const Vec3& p,
+                                     const float radius,
+                                     std::vector<int>& result) const
+{
+    if (columns == 0) return;
+
+    const float radiusSquared = radius * radius;
+    const int c0 = column (p.x - radius), c1 = column (p.x + radius);
+    const int r0 = row (p.z - radius), r1 = row (p.z + radius);
+    for (int r = r0; r <= r1; r++)
+    {
+        for (int c = c0; c <= c1; c++)
+        {
+            const int cell = r * columns + c;
+            for (int k = cellStart[cell]; k < cellStart[cell + 1]; k++)
+            {
+                const float dx = positions[2*k] - p.x;
+                const float dz = positions[2*k+1] - p.z;
+                if (dx * dx + dz * dz <= radiusSquared)
+                    result.push_back (cellPoints[k]);
+            }
+        }
+    }
+}
+
+
+void 
+OpenSteer::SpatialGrid::queryNearest (const Vec3& p,
+                                       const size_t k,
+                                       const float radius,
+                                       std::vector<std::pair<float, int> >& result) const
+{
+    result.clear ();
+    if (columns == 0 || k == 0) return;
+
+    // result is a max-heap on distance while searching.  Rings as in
+    // nearest: every point beyond ring r is at least r cells away.
+    const float radiusSquared = radius * radius;
+    const int pc = column (p.x);
+    const int pr = row (p.z);
+    const int maxRing = std::max (columns, rows);
+    for (int ring = 0; ring <= maxRing; ring++)
+    {
+        const float reach = square (std::max (0.0f, ring * cellSize - cellSize));
+        if (reach > radiusSquared) break;
+        if (result.size () == k && result.front().first <= reach) break;
+
+        for (int r = pr - ring; r <= pr + ring; r++)
+        {
+            if (r < 0 || r >= rows) continue;
+            const bool edgeRow = (r == pr - ring) || (r == pr + ring);
+            const int step = edgeRow ? 1 : 2 * ring;
+            for (int c = pc - ring; c <= pc + ring; c += step)
+            {
+                if (c < 0 || c >= columns) continue;
+                const int cell = r * columns + c;
+                for (int j = cellStart[cell]; j < cellStart[cell + 1]; j++)
+                {
+                    const float dx = positions[2*j] - p.x;
+                    const float dz = positions[2*j+1] - p.z;
+                    const float d = dx * dx + dz * dz;
+                    if (d > radiusSquared) continue;
+                    if (result.size () < k)
+                    {
+                        result.push_back (std::make_pair (d, cellPoints[j]));
+                        std::push_heap (result.begin (), result.end ());
+                    }
+                    else if (d < result.front().first)
+                    {
+                        std::pop_heap (result.begin (), result.end ());
+                        result.back () = std::make_pair (d, cellPoints[j]);
+                        std::push_heap (result.begin (), result.end ());
+                    }
+                }
+            }
+        }
+    }
+    std::sort_heap (result.begin (), result.end ());
+}
+
+
+// ----------------------------------------------------------------------------
@@ -0,0 +1,426 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// TaskScheduler: a work-stealing pool for data parallel frame phases
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#include "OpenSteer/TaskScheduler.h"
+#include "OpenSteer/Profile.h"
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <ostream>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+
+// ----------------------------------------------------------------------------
+
+
+struct OpenSteer::TaskScheduler::Queue
+{
+    std::mutex mutex;
+    std::deque<Item> items;
+    std::atomic<size_t> tasksRun;
+    std::atomic<size_t> steals;
+
+    Queue (void) : tasksRun (0), steals (0) {}
+};
+
+
+namespace {
+
+    // the scheduler whose worker the current thread is, and its index
+    thread_local const void* workerOf = 0;
+    thread_local int workerIndex = -1;
+
+    void pinCurrentThread (const int cpu)
+    {
+#ifdef __linux__
+        cpu_set_t set;
+        CPU_ZERO (&set);
+        CPU_SET (cpu, &set);
+        pthread_setaffinity_np (pthread_self (), sizeof (set), &set);
+#else
+        (void) cpu;
+#endif
+    }
+
+    int zoneFor (const char* name)
+    {
+#ifdef OPENSTEER_PROFILE
+        return OpenSteer::Profiler::registerZone (name);
+#else
+        (void) name;
+        return 0;
+#endif
+    }
+
+} // anonymous namespace
+
+
+// ----------------------------------------------------------------------------
+
+
+OpenSteer::TaskScheduler::TaskScheduler (const int threadCount,
+                                         const bool pinThreads)
+    : queued (0),
+      stopping (false),
+      hook (0)
+{
+    int threads = threadCount;
+    if (threads <= 0) threads = std::thread::hardware_concurrency ();
+    if (threads <= 0) threads = 1;
+    const int cpus = std::max (1, (int) std::thread::hardware_concurrency ());
+
+    // one queue per worker, and the last for threads outside the pool
+    for (int q = 0; q < threads; q++)
+        queues.push_back (std::unique_ptr<Queue> (new Queue));
+
+    // the caller is the extra thread: it works while it waits
+    for (int w = 0; w < threads - 1; w++)
+        workers.push_back (std::thread (&TaskScheduler::workerLoop, this,
+                                        w, pinThreads ? w % cpus : -1));
+}
+
+
+OpenSteer::TaskScheduler::~TaskScheduler (void)
+{
+    {
+        std::lock_guard<std::mutex> lock (sleepMutex);
+        stopping = true;
+    }
+    sleepCondition.notify_all ();
+    for (size_t w = 0; w < workers.size (); w++) workers[w].join ();
+}
+
+
+int 
+OpenSteer::TaskScheduler::currentQueue (void) const
+{
+    return (workerOf == this) ? workerIndex : (int) queues.size () - 1;
+}
+
+
+void 
+OpenSteer::TaskScheduler::workerLoop (const int self, const int cpu)
+{
+    workerOf = this;
+    workerIndex = self;
+    if (cpu >= 0) pinCurrentThread (cpu);
+
+    for (;;)
+    {
+        if (runOne (self)) continue;
+        std::unique_lock<std::mutex> lock (sleepMutex);
+        sleepCondition.wait (lock, [this] ()
+                             {return stopping || queued > 0;});
+        if (stopping) return;
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+void 
+OpenSteer::TaskScheduler::push (const Item& item)
+{
+    item.group->pending++;
+
+    // count it before it can be taken (runOne decrements the count), and
+    // under the sleep lock so a worker about to sleep sees it
+    if (workers.empty ())
+    {
+        queued++;
+    }
+    else
+    {
+        std::lock_guard<std::mutex> lock (sleepMutex);
+        queued++;
+    }
+
+    Queue& q = *queues[currentQueue ()];
+    {
+        std::lock_guard<std::mutex> lock (q.mutex);
+        q.items.push_back (item);
+    }
+    if (! workers.empty ()) sleepCondition.notify_one ();
+}
+
+
+bool 
+OpenSteer::TaskScheduler::runOne (const int self)
+{
+    const int n = (int) queues.size ();
+    Item item;
+    bool found = false;
+
+    // take from the front of our own queue, else steal from the back of
+    // another's
+    for (int v = 0; !found && v < n; v++)
+    {
+        Queue& q = *queues[(self + v) % n];
+        std::lock_guard<std::mutex> lock (q.mutex);
+        if (q.items.empty ()) continue;
+        if (v == 0)
+        {
+            item = q.items.front ();
+            q.items.pop_front ();
+        }
+        else
+        {
+            item = q.items.back ();
+            q.items.pop_back ();
+            queues[self]->steals++;
+        }
+        found = true;
+    }
+    if (! found) return false;
+
+    queued--;
+    execute (item, self);
+    return true;
+}
+
+
+void 
+OpenSteer::TaskScheduler::execute (const Item& item, const int self)
+{
+    const std::chrono::steady_clock::time_point start =
+        hook ? std::chrono::steady_clock::now ()
+             : std::chrono::steady_clock::time_point ();
+    {
+#ifdef OPENSTEER_PROFILE
+        ProfileZone zone (item.zone);
+#endif
+        try
+        {
+            item.task ();
+        }
+        catch (...)
+        {
+            // keep the first, for wait to rethrow
+            if (! item.group->failed.exchange (true))
+                item.group->error = std::current_exception ();
+        }
+    }
+    if (hook)
+        hook (item.name, self, std::chrono::duration<double>
+              (std::chrono::steady_clock::now () - start).count ());
+    queues[self]->tasksRun++;
+    item.group->pending--;
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+void 
+OpenSteer::TaskScheduler::spawn (TaskGroup& group,
+                                 const Task& task,
+                                 const char* name)
+{
+    Item item;
+    item.task = task;
+    item.group = &group;
+    item.name = name;
+    item.zone = zoneFor (name);
+    push (item);
+}
+
+
+void 
+OpenSteer::TaskScheduler::wait (TaskGroup& group)
+{
+    const int self = currentQueue ();
+    while (group.pending > 0)
+        if (! runOne (self)) std::this_thread::yield ();
+    if (group.failed) std::rethrow_exception (group.error);
+}
+
+
+void 
+OpenSteer::TaskScheduler::parallelFor (const size_t begin,
+                                       const size_t end,
+                                       const size_t grain,
+                                       const RangeTask& body,
+                                       const char* name)
+{
+    if (begin >= end) return;
+    const size_t g = std::max ((size_t) 1, grain);
+
+    Item item;
+    item.name = name;
+    item.zone = zoneFor (name);
+
+    // a single chunk, or no other thread to share it with: run it here
+    if (end - begin <= g || workers.empty ())
+    {
+        TaskGroup group;
+        group.pending++;
+        item.group = &group;
+        item.task = [&] () {body (begin, end);};
+        execute (item, currentQueue ());
+        if (group.failed) std::rethrow_exception (group.error);
+        return;
+    }
+
+    TaskGroup group;
+    item.group = &group;
+    for (size_t b = begin; b < end; b += g)
+    {
+        const size_t e = std::min (end, b + g);
+        item.task = [&body, b, e] () {body (b, e);};
+        push (item);
+    }
+    wait (group);
+}
+
+
+// ----------------------------------------------------------------------------
+
+
+size_t 
+OpenSteer::TaskScheduler::tasksRun (const int thread) const
+{
+    return queues[thread]->tasksRun;
+}
+
+
+size_t 
+OpenSteer::TaskScheduler::stealCount (void) const
+{
+    size_t steals = 0;
+    for (size_t q = 0; q < queues.size (); q++) steals += queues[q]->steals;
+    return steals;
+}
+
+
+void 
+OpenSteer::TaskScheduler::printReport (std::ostream& o) const
+{
+    size_t total = 0;
+    for (size_t q = 0; q < queues.size (); q++) total += queues[q]->tasksRun;
+    o << "tasks: " << total << " on " << threadCount () << " threads, "
+      << stealCount () << " stolen" << std::endl;
+    o << "tasks: per thread:";
+    for (size_t q = 0; q < queues.size (); q++)
+        o << " " << queues[q]->tasksRun;
+    o << std::endl;
+}
+
+
+void 
+OpenSteer::TaskScheduler::resetCounters (void)
+{
+    for (size_t q = 0; q < queues.size (); q++)
+    {
+        queues[q]->tasksRun = 0;
+        queues[q]->steals = 0;
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+// FrameGraph
+
+
+OpenSteer::FrameGraph::Phase 
+OpenSteer::FrameGraph::addPhase (const char* name,
+                                 const TaskScheduler::Task& work)
+{
+    Node node;
+    node.name = name;
+    node.work = work;
+    node.dependencies = 0;
+    node.seconds = 0;
+    phases.push_back (node);
+    return phases.size () - 1;
+}
+
+
+void 
+OpenSteer::FrameGraph::addDependency (const Phase before, const Phase after)
+{
+    phases[before].successors.push_back (after);
+    phases[after].dependencies++;
+}
+
+
+void 
+OpenSteer::FrameGraph::start (TaskScheduler& scheduler,
+                              TaskScheduler::TaskGroup& group,
+                              const Phase p)
+{
+    scheduler.spawn (group, [this, &scheduler, &group, p] ()
+    {
+        Node& node = phases[p];
+        const std::chrono::steady_clock::time_point begin =
+            std::chrono::steady_clock::now ();
+        node.work ();
+        node.seconds = std::chrono::duration<double>
+            (std::chrono::steady_clock::now () - begin).count ();
+
+        // the last dependency of a successor to finish starts it
+        for (size_t s = 0; s < node.successors.size (); s++)
+        {
+            const Phase next = node.successors[s];
+            if (--remaining[next] == 0) start (scheduler, group, next);
+        }
+    }, phases[p].name);
+}
+
+
+void 
+OpenSteer::FrameGraph::run (TaskScheduler& scheduler)
+{
+    if (remainingSize != phases.size ())
+    {
+        remainingSize = phases.size ();
+        remaining.reset (new std::atomic<size_t>[remainingSize]);
+    }
+    for (size_t p = 0; p < phases.size (); p++)
+        remaining[p] = phases[p].dependencies;
+
+    TaskScheduler::TaskGroup group;
+    for (size_t p = 0; p < phases.size (); p++)
+        if (phases[p].dependencies == 0) start (scheduler, group, p);
+    scheduler.wait (group);
+}
+
+
+// ----------------------------------------------------------------------------
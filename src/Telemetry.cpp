@@ -0,0 +1,601 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// Telemetry: binary stream of per-frame agent states for offline analysis
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#include "OpenSteer/Telemetry.h"
+#include "OpenSteer/Utilities.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <math.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+
+namespace {
+
+    // file layout: this header (padded to headerBytes), then a ring of
+    // "capacity" bytes holding whole frame records, each starting with a
+    // RecordHeader.  Positions in the ring are byte counts ever written;
+    // the live records are those in [tail, head).
+    struct FileHeader
+    {
+        char magic[8];              // "OSTELEM" padded with a zero
+        uint32_t version;           // Telemetry::version
+        uint32_t format;            // Telemetry::Format
+        float positionQuantum;
+        float speedQuantum;
+        uint64_t capacity;
+        uint64_t head;
+        uint64_t tail;
+        uint64_t framesStaged;
+        uint64_t framesDropped;
+    };
+
+    const size_t headerBytes = 64;
+    const char telemetryMagic[8] = {'O', 'S', 'T', 'E', 'L', 'E', 'M', 0};
+
+    struct RecordHeader
+    {
+        uint32_t bytes;             // whole record, this header included
+        uint32_t frame;
+        float time;
+        uint32_t agentCount;
+        uint32_t flags;             // keyframeFlag
+    };
+
+    const uint32_t keyframeFlag = 1;
+
+    // per agent entries
+    struct RawEntry
+    {
+        uint32_t id;
+        float x, y, z;
+        float heading;
+        float speed;
+    };
+
+    const uint8_t fullTag = 0;      // id, 3 x int32 position
+    const uint8_t deltaTag = 1;     // 3 x int16 position delta
+    const size_t fullEntryBytes = 1 + 4 + 12 + 4;
+    const size_t deltaEntryBytes = 1 + 6 + 4;
+
+    const float headingScale = 65536 / (2 * OPENSTEER_M_PI);
+
+    bool telemetryError (const std::string& path, const char* problem)
+    {
+        std::cerr << "Telemetry: " << path << ": " << problem << std::endl;
+        return false;
+    }
+
+    // copy between a linear buffer and a ring (size a power of two, or
+    // any size for the file ring) at a position that may wrap
+    void ringWrite (uint8_t* ring, const size_t size, const uint64_t at,
+                    const void* data, const size_t bytes)
+    {
+        const size_t offset = at % size;
+        const size_t first = std::min (bytes, size - offset);
+        std::memcpy (ring + offset, data, first);
+        std::memcpy (ring, (const uint8_t*) data + first, bytes - first);
+    }
+
+    void ringRead (const uint8_t* ring, const size_t size, const uint64_t at,
+                   void* data, const size_t bytes)
+    {
+        const size_t offset = at % size;
+        const size_t first = std::min (bytes, size - offset);
+        std::memcpy (data, ring + offset, first);
+        std::memcpy ((uint8_t*) data + first, ring, bytes - first);
+    }
+
+} // anonymous namespace
+
+
+// ----------------------------------------------------------------------------
+// TelemetryWriter
+
+
+OpenSteer::TelemetryWriter::TelemetryWriter (void)
+    : stagingMask (0),
+      stagingWrite (0),
+      stagingRead (0),
+      frameStart (0),
+      cursor (0),
+      dropping (true),
+      keyframe (false),
+      slot (0),
+      framesSinceKey (0),
+      previousCount (0),
+      pendingFrame (0),
+      pendingTime (0),
+      pendingCount (0),
+      staged (0),
+      dropped (0),
+      fd (-1),
+      mapping (0),
+      mappingBytes (0),
+      stopping (false)
+{
+}
+
+
+OpenSteer::TelemetryWriter::~TelemetryWriter (void)
+{
+    close ();
+}
+
+
+bool 
+OpenSteer::TelemetryWriter::open (const std::string& path, const Options& o)
+{
+    close ();
+    if (o.fileBytes < headerBytes + 4096)
+        return telemetryError (path, "ring file too small");
+    options = o;
+    if (options.keyframeInterval < 1) options.keyframeInterval = 1;
+
+    // staging ring size: a power of two so positions wrap with a mask
+    size_t stagingSize = 4096;
+    while (stagingSize < options.stagingBytes) stagingSize *= 2;
+    staging.assign (stagingSize, 0);
+    stagingMask = stagingSize - 1;
+    stagingWrite = 0;
+    stagingRead = 0;
+
+    fd = ::open (path.c_str (), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return telemetryError (path, "can not create file");
+    if (ftruncate (fd, options.fileBytes) != 0)
+    {
+        close ();
+        return telemetryError (path, "can not size file");
+    }
+    void* m = mmap (0, options.fileBytes, PROT_READ | PROT_WRITE,
+                    MAP_SHARED, fd, 0);
+    if (m == MAP_FAILED)
+    {
+        close ();
+        return telemetryError (path, "can not map file");
+    }
+    mapping = (uint8_t*) m;
+    mappingBytes = options.fileBytes;
+
+    FileHeader header;
+    std::memset (&header, 0, sizeof (header));
+    std::memcpy (header.magic, telemetryMagic, sizeof (header.magic));
+    header.version = Telemetry::version;
+    header.format = options.format;
+    header.positionQuantum = options.positionQuantum;
+    header.speedQuantum = options.speedQuantum;
+    header.capacity = mappingBytes - headerBytes;
+    std::memcpy (mapping, &header, sizeof (header));
+
+    // the first quantized frame is a keyframe
+    framesSinceKey = options.keyframeInterval;
+    previousCount = 0;
+    staged = 0;
+    dropped = 0;
+    dropping = true;
+
+    stopping = false;
+    flusher = std::thread (&TelemetryWriter::flushLoop, this);
+    return true;
+}
+
+
+void 
+OpenSteer::TelemetryWriter::close (void)
+{
+    if (flusher.joinable ())
+    {
+        {
+            std::lock_guard<std::mutex> lock (flushMutex);
+            stopping = true;
+        }
+        flushCondition.notify_one ();
+        flusher.join ();
+    }
+    if (mapping)
+    {
+        msync (mapping, mappingBytes, MS_SYNC);
+        munmap (mapping, mappingBytes);
+        mapping = 0;
+    }
+    if (fd >= 0) ::close (fd);
+    fd = -1;
+    staging.clear ();
+}
+
+
+// ----------------------------------------------------------------------------
+// TelemetryWriter: encoding, on the simulation thread
+
+
+void 
+OpenSteer::TelemetryWriter::stage (const void* data, const size_t bytes)
+{
+    ringWrite (&staging[0], staging.size (), cursor, data, bytes);
+    cursor += bytes;
+}
+
+
+bool 
+OpenSteer::TelemetryWriter::beginFrame (const uint32_t frame,
+                                        const float time,
+                                        const size_t agentCount)
+{
+    dropping = true;
+    if (! isOpen ()) return false;
+
+    // drop the frame rather than wait if its largest encoding does not fit
+    const bool raw = options.format == Telemetry::raw;
+    const size_t worst = sizeof (RecordHeader) +
+        agentCount * (raw ? sizeof (RawEntry) : fullEntryBytes);
+    const uint64_t used = stagingWrite.load (std::memory_order_relaxed) -
+                          stagingRead.load (std::memory_order_acquire);
+    if (worst > staging.size () - used || worst > mappingBytes - headerBytes)
+    {
+        dropped++;
+        framesSinceKey = options.keyframeInterval; // next one is a keyframe
+        return false;
+    }
+
+    dropping = false;
+    keyframe = raw || (framesSinceKey >= (uint32_t) options.keyframeInterval);
+    pendingFrame = frame;
+    pendingTime = time;
+    pendingCount = agentCount;
+    frameStart = stagingWrite.load (std::memory_order_relaxed);
+    cursor = frameStart + sizeof (RecordHeader);
+    slot = 0;
+
+    // grows only when the agent count exceeds any seen before
+    if (! raw && previousId.size () < agentCount)
+    {
+        previousId.resize (agentCount);
+        previousPosition.resize (agentCount * 3);
+    }
+    return true;
+}
+
+
+void 
+OpenSteer::TelemetryWriter::addAgent (const uint32_t id,
+                                      const Vec3& position,
+                                      const Vec3& forward,
+                                      const float speed)
+{
+    if (dropping || slot >= pendingCount) return;
+
+    // heading: yaw of forward about +Y, 0 along +Z
+    const float heading = atan2f (forward.x, forward.z);
+
+    if (options.format == Telemetry::raw)
+    {
+        const RawEntry e = {id, position.x, position.y, position.z,
+                            heading, speed};
+        stage (&e, sizeof (e));
+        slot++;
+        return;
+    }
+
+    const float q = options.positionQuantum;
+    const int32_t p[3] = {(int32_t) lroundf (position.x / q),
+                          (int32_t) lroundf (position.y / q),
+                          (int32_t) lroundf (position.z / q)};
+    const float turns = heading < 0 ? heading + 2 * OPENSTEER_M_PI : heading;
+    const uint16_t h = (uint16_t) (lroundf (turns * headingScale) & 0xffff);
+    const uint16_t s = (uint16_t) std::min (65535L,
+        std::max (0L, lroundf (speed / options.speedQuantum)));
+
+    int32_t* previous = &previousPosition[slot * 3];
+    const int32_t d[3] = {p[0] - previous[0],
+                          p[1] - previous[1],
+                          p[2] - previous[2]};
+    const bool delta = (! keyframe) && slot < previousCount &&
+                       previousId[slot] == id &&
+                       abs (d[0]) <= 32767 && abs (d[1]) <= 32767 &&
+                       abs (d[2]) <= 32767;
+
+    uint8_t entry[fullEntryBytes];
+    size_t n = 0;
+    if (delta)
+    {
+        const int16_t d16[3] = {(int16_t) d[0], (int16_t) d[1],
+                                (int16_t) d[2]};
+        entry[n++] = deltaTag;
+        std::memcpy (entry + n, d16, sizeof (d16)); n += sizeof (d16);
+    }
+    else
+    {
+        entry[n++] = fullTag;
+        std::memcpy (entry + n, &id, sizeof (id)); n += sizeof (id);
+        std::memcpy (entry + n, p, sizeof (p)); n += sizeof (p);
+    }
+    std::memcpy (entry + n, &h, sizeof (h)); n += sizeof (h);
+    std::memcpy (entry + n, &s, sizeof (s)); n += sizeof (s);
+    stage (entry, n);
+
+    previousId[slot] = id;
+    previous[0] = p[0];
+    previous[1] = p[1];
+    previous[2] = p[2];
+    slot++;
+}
+
+
+bool 
+OpenSteer::TelemetryWriter::endFrame (void)
+{
+    if (dropping) return false;
+    dropping = true;
+
+    RecordHeader header;
+    header.bytes = (uint32_t) (cursor - frameStart);
+    header.frame = pendingFrame;
+    header.time = pendingTime;
+    header.agentCount = (uint32_t) slot;
+    header.flags = keyframe ? keyframeFlag : 0;
+    ringWrite (&staging[0], staging.size (), frameStart,
+               &header, sizeof (header));
+
+    previousCount = slot;
+    framesSinceKey = keyframe ? 1 : framesSinceKey + 1;
+    stagingWrite.store (cursor, std::memory_order_release);
+    staged++;
+
+    // past half full, don't wait for the flush period
+    const uint64_t used = cursor - stagingRead.load (std::memory_order_relaxed);
+    if (used > staging.size () / 2) flushCondition.notify_one ();
+    return true;
+}
+
+
+// ----------------------------------------------------------------------------
+// TelemetryWriter: flushing, on the background thread
+
+
+void 
+OpenSteer::TelemetryWriter::flushLoop (void)
+{
+    const std::chrono::duration<double> period (options.flushSeconds);
+    for (;;)
+    {
+        bool stop;
+        {
+            std::unique_lock<std::mutex> lock (flushMutex);
+            flushCondition.wait_for (lock, period);
+            stop = stopping;
+        }
+        drain ();
+        if (stop) return;
+    }
+}
+
+
+void 
+OpenSteer::TelemetryWriter::drain (void)
+{
+    FileHeader header;
+    std::memcpy (&header, mapping, sizeof (header));
+    uint8_t* ring = mapping + headerBytes;
+    const size_t capacity = header.capacity;
+
+    uint64_t read = stagingRead.load (std::memory_order_relaxed);
+    const uint64_t write = stagingWrite.load (std::memory_order_acquire);
+    const bool moved = read != write;
+    while (read < write)
+    {
+        RecordHeader record;
+        ringRead (&staging[0], staging.size (), read,
+                  &record, sizeof (record));
+
+        // overwrite the oldest frames to make room
+        while (header.head + record.bytes - header.tail > capacity)
+        {
+            uint32_t oldest;
+            ringRead (ring, capacity, header.tail, &oldest, sizeof (oldest));
+            header.tail += oldest;
+        }
+
+        // copy the record across both rings' wrap points
+        uint64_t from = read;
+        size_t left = record.bytes;
+        while (left)
+        {
+            const size_t offset = from & stagingMask;
+            const size_t n = std::min (left, staging.size () - offset);
+            ringWrite (ring, capacity, header.head, &staging[offset], n);
+            header.head += n;
+            from += n;
+            left -= n;
+        }
+        read += record.bytes;
+    }
+    stagingRead.store (read, std::memory_order_release);
+
+    header.framesStaged = staged;
+    header.framesDropped = dropped;
+    std::memcpy (mapping, &header, sizeof (header));
+    if (moved) msync (mapping, mappingBytes, MS_ASYNC);
+}
+
+
+// ----------------------------------------------------------------------------
+// TelemetryReader
+
+
+bool 
+OpenSteer::TelemetryReader::open (const std::string& path)
+{
+    records.clear ();
+    position = 0;
+    sawKeyframe = false;
+    previousCount = 0;
+
+    std::ifstream in (path.c_str (), std::ios::binary);
+    if (! in) return telemetryError (path, "can not open file");
+
+    FileHeader header;
+    if (! in.read ((char*) &header, sizeof (header)))
+        return telemetryError (path, "truncated header");
+    if (std::memcmp (header.magic, telemetryMagic, sizeof (header.magic)) != 0)
+        return telemetryError (path, "not a telemetry file");
+    if (header.version != Telemetry::version)
+        return telemetryError (path, "unsupported version");
+    if (header.format > Telemetry::quantized ||
+        header.head < header.tail ||
+        header.head - header.tail > header.capacity)
+        return telemetryError (path, "corrupt header");
+
+    std::vector<uint8_t> ring (header.capacity);
+    in.seekg (headerBytes);
+    if (! in.read ((char*) &ring[0], ring.size ()))
+        return telemetryError (path, "truncated ring");
+
+    // unwrap the live records, oldest first
+    records.resize (header.head - header.tail);
+    if (! records.empty ())
+        ringRead (&ring[0], ring.size (), header.tail,
+                  &records[0], records.size ());
+
+    fileFormat = (Telemetry::Format) header.format;
+    positionQuantum = header.positionQuantum;
+    speedQuantum = header.speedQuantum;
+    stagedCount = header.framesStaged;
+    droppedCount = header.framesDropped;
+    return true;
+}
+
+
+bool 
+OpenSteer::TelemetryReader::next (Frame& f)
+{
+    for (;;)
+    {
+        RecordHeader header;
+        if (position + sizeof (header) > records.size ()) return false;
+        std::memcpy (&header, &records[position], sizeof (header));
+        if (header.bytes < sizeof (header) ||
+            position + header.bytes > records.size ())
+            return false;
+        const uint8_t* p = &records[position] + sizeof (header);
+        const uint8_t* end = &records[position] + header.bytes;
+        position += header.bytes;
+
+        f.frame = header.frame;
+        f.time = header.time;
+        f.keyframe = (header.flags & keyframeFlag) != 0;
+        f.agents.resize (header.agentCount);
+
+        if (fileFormat == Telemetry::raw)
+        {
+            if ((size_t) (end - p) < header.agentCount * sizeof (RawEntry))
+                return false;
+            for (size_t i = 0; i < header.agentCount; i++)
+            {
+                RawEntry e;
+                std::memcpy (&e, p, sizeof (e));
+                p += sizeof (e);
+                Telemetry::AgentState& a = f.agents[i];
+                a.id = e.id;
+                a.position.set (e.x, e.y, e.z);
+                a.heading = e.heading;
+                a.speed = e.speed;
+            }
+            return true;
+        }
+
+        // quantized: delta frames before the first keyframe can't be
+        // decoded
+        if (! sawKeyframe && ! f.keyframe) continue;
+        sawKeyframe = true;
+
+        if (previousId.size () < header.agentCount)
+        {
+            previousId.resize (header.agentCount);
+            previousPosition.resize (header.agentCount * 3);
+        }
+        for (size_t i = 0; i < header.agentCount; i++)
+        {
+            if (p >= end) return false;
+            const uint8_t tag = *p++;
+            int32_t* q = &previousPosition[i * 3];
+            if (tag == deltaTag)
+            {
+                if (i >= previousCount ||
+                    (size_t) (end - p) < deltaEntryBytes - 1)
+                    return false;
+                int16_t d[3];
+                std::memcpy (d, p, sizeof (d));
+                p += sizeof (d);
+                q[0] += d[0];
+                q[1] += d[1];
+                q[2] += d[2];
+            }
+            else
+            {
+                if ((size_t) (end - p) < fullEntryBytes - 1) return false;
+                std::memcpy (&previousId[i], p, sizeof (uint32_t));
+                p += sizeof (uint32_t);
+                std::memcpy (q, p, 3 * sizeof (int32_t));
+                p += 3 * sizeof (int32_t);
+            }
+            uint16_t h, s;
+            std::memcpy (&h, p, sizeof (h));
+            p += sizeof (h);
+            std::memcpy (&s, p, sizeof (s));
+            p += sizeof (s);
+
+            Telemetry::AgentState& a = f.agents[i];
+            a.id = previousId[i];
+            a.position.set (q[0] * positionQuantum,
+                            q[1] * positionQuantum,
+                            q[2] * positionQuantum);
+            const float heading = h / headingScale;
+            a.heading = heading > OPENSTEER_M_PI ?
+                heading - 2 * OPENSTEER_M_PI : heading;
+            a.speed = s * speedQuantum;
+        }
+        previousCount = header.agentCount;
+        return true;
+    }
+}
+
+
+// ----------------------------------------------------------------------------
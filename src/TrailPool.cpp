@@ -0,0 +1,146 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// TrailPool: shared storage for AnnotationMixin's trail ring buffers
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#include "OpenSteer/TrailPool.h"
+
+#include <mutex>
+#include <new>
+#include <vector>
+
+
+namespace {
+
+    // blocks are allocated this many at a time
+    const int blocksPerChunk = 32;
+
+    // all the blocks of one vertexCount
+    struct SizeClass
+    {
+        int vertexCount;
+        size_t blockBytes;
+        std::vector<char*> freeBlocks;
+        std::vector<char*> chunks;
+    };
+
+    std::vector<SizeClass> sizeClasses;
+    std::mutex poolMutex;
+    int inUse = 0;
+    int allocated = 0;
+
+    SizeClass& findSizeClass (const int vertexCount)
+    {
+        for (size_t i = 0; i < sizeClasses.size (); i++)
+            if (sizeClasses[i].vertexCount == vertexCount)
+                return sizeClasses[i];
+
+        // a block holds the vertex ring followed by the flag ring
+        SizeClass c;
+        c.vertexCount = vertexCount;
+        c.blockBytes = (vertexCount * sizeof (OpenSteer::Vec3)) + vertexCount;
+        c.blockBytes = (c.blockBytes + 15) & ~(size_t) 15; // keep alignment
+        sizeClasses.push_back (c);
+        return sizeClasses.back ();
+    }
+
+    void addChunk (SizeClass& c)
+    {
+        char* chunk = new char [c.blockBytes * blocksPerChunk];
+        c.chunks.push_back (chunk);
+        for (int i = blocksPerChunk - 1; i >= 0; i--)
+        {
+            char* block = chunk + (i * c.blockBytes);
+            new (block) OpenSteer::Vec3 [c.vertexCount];
+            c.freeBlocks.push_back (block);
+        }
+        allocated += blocksPerChunk;
+    }
+
+} // anonymous namespace
+
+
+// ----------------------------------------------------------------------------
+
+
+void 
+OpenSteer::TrailPool::acquire (const int vertexCount,
+                               Vec3*& vertices,
+                               char*& flags)
+{
+    std::lock_guard<std::mutex> lock (poolMutex);
+    SizeClass& c = findSizeClass (vertexCount);
+    if (c.freeBlocks.empty ()) addChunk (c);
+
+    char* block = c.freeBlocks.back ();
+    c.freeBlocks.pop_back ();
+    inUse++;
+
+    vertices = (Vec3*) block;
+    flags = block + (vertexCount * sizeof (Vec3));
+}
+
+
+void 
+OpenSteer::TrailPool::release (const int vertexCount,
+                               Vec3*& vertices,
+                               char*& flags)
+{
+    if (vertices == NULL) return;
+
+    std::lock_guard<std::mutex> lock (poolMutex);
+    findSizeClass (vertexCount).freeBlocks.push_back ((char*) vertices);
+    inUse--;
+
+    vertices = NULL;
+    flags = NULL;
+}
+
+
+int 
+OpenSteer::TrailPool::blocksInUse (void)
+{
+    std::lock_guard<std::mutex> lock (poolMutex);
+    return inUse;
+}
+
+
+int 
+OpenSteer::TrailPool::blocksAllocated (void)
+{
+    std::lock_guard<std::mutex> lock (poolMutex);
+    return allocated;
+}
+
+
+// ----------------------------------------------------------------------------
@@ -37,19 +37,109 @@
 
 
 #include "OpenSteer/OpenSteerDemo.h"        // OpenSteerDemo application
+#include "OpenSteer/Metrics.h"              // runtime metrics export
+#include "OpenSteer/Random.h"               // setRandomSeed
 
 
 // To include EXIT_SUCCESS
 #include <cstdlib>
+#include <cstring>
 
 
 int main (int argc, char **argv) 
 {
+    // optionally export runtime metrics (Prometheus text format) every five
+    // seconds, for a local node-exporter textfile collector:
+    //     OpenSteerDemo --metrics-file /var/lib/node_exporter/opensteer.prom
+    //
+    // --seed N selects the random seed all vehicles' streams derive from
+    //
+    // --record <path> saves the session's input for later replay, and
+    // --replay <path> runs a recorded session headlessly at full speed
+    // (give it the same --scenario the session was recorded with)
+    //
+    // --batch N [--threads T] steps N independent worlds of the scenario
+    // on T threads (default: all) and reports throughput
+    //
+    // --workers N runs each frame's phases on N threads (default: all),
+    // --pin-workers pins them to CPUs
+    //
+    // --telemetry <path> streams per frame agent states to a ring file for
+    // offline analysis (see Telemetry.h), --telemetry-quantized makes it
+    // the compact quantized/delta encoding
+    //
+    // --share <name> publishes per frame agent arrays to a POSIX shared
+    // memory segment for external viewers (see tools/SharedStateView.cpp)
+    //
+    // --control <path> accepts batched commands from other processes on a
+    // Unix domain socket (see ControlServer.h); --record records them
+    //
+    // --scenario <path> configures populations, world and run length (see
+    // Scenario.h); it is applied first so --seed can override its seed
+    for (int i = 1; i + 1 < argc; i++)
+    {
+        if (std::strcmp (argv[i], "--scenario") == 0 &&
+            ! OpenSteer::loadScenario (argv[i + 1]))
+            return EXIT_FAILURE;
+    }
+
+    const char* replayPath = 0;
+    size_t batchWorlds = 0;
+    int batchThreads = 0;
+    int workers = 0;
+    bool pinWorkers = false;
+    bool telemetryQuantized = false;
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strcmp (argv[i], "--pin-workers") == 0) pinWorkers = true;
+        if (std::strcmp (argv[i], "--telemetry-quantized") == 0)
+            telemetryQuantized = true;
+    }
+    for (int i = 1; i + 1 < argc; i++)
+    {
+        if (std::strcmp (argv[i], "--metrics-file") == 0)
+            OpenSteer::Metrics::startFileExporter (argv[i + 1], 5);
+        if (std::strcmp (argv[i], "--seed") == 0)
+            OpenSteer::setRandomSeed (std::strtoull (argv[i + 1], 0, 10));
+        if (std::strcmp (argv[i], "--record") == 0)
+            OpenSteer::setInputRecordFile (argv[i + 1]);
+        if (std::strcmp (argv[i], "--replay") == 0)
+            replayPath = argv[i + 1];
+        if (std::strcmp (argv[i], "--batch") == 0)
+            batchWorlds = std::strtoul (argv[i + 1], 0, 10);
+        if (std::strcmp (argv[i], "--threads") == 0)
+            batchThreads = std::atoi (argv[i + 1]);
+        if (std::strcmp (argv[i], "--workers") == 0)
+            workers = std::atoi (argv[i + 1]);
+        if (std::strcmp (argv[i], "--telemetry") == 0)
+            OpenSteer::setTelemetryFile (argv[i + 1], telemetryQuantized);
+        if (std::strcmp (argv[i], "--share") == 0)
+            OpenSteer::setSharedStateName (argv[i + 1]);
+        if (std::strcmp (argv[i], "--control") == 0)
+            OpenSteer::setControlSocket (argv[i + 1]);
+    }
+    OpenSteer::setWorkerThreads (workers, pinWorkers);
+
+    if (batchWorlds)
+    {
+        OpenSteer::runBatch (batchWorlds, batchThreads);
+        OpenSteer::Metrics::stopFileExporter ();
+        return EXIT_SUCCESS;
+    }
+
+    if (replayPath)
+    {
+        const bool ok = OpenSteer::replay (replayPath);
+        OpenSteer::Metrics::stopFileExporter ();
+        return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
 
     // initialize OpenSteerDemo application
     OpenSteer::OpenSteerDemo::initialize ();
     OpenSteer::run();
 
+    OpenSteer::Metrics::stopFileExporter ();
+
     return EXIT_SUCCESS;
 }
 
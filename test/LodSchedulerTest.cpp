@@ -0,0 +1,111 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// LodSchedulerTest: stepped time matches elapsed frames across tier changes
+//
+// Moves agents back and forth between a fine and two coarse tiers (and
+// holds some now and then, as if asleep) over many frames, and checks
+// that each step covers exactly the frames the agent was not held since
+// its last step, so that its summed steps equal those frames, less at
+// most one coarsest period not yet stepped.
+//
+// Usage:
+//         LodSchedulerTest
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#include "OpenSteer/LodScheduler.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+
+int main (int /*argc*/, char** /*argv*/)
+{
+    using namespace OpenSteer;
+
+    std::vector<LodScheduler::Tier> tiers (3);
+    tiers[0].maxDistance = 10;  tiers[0].period = 1;
+    tiers[1].maxDistance = 50;  tiers[1].period = 3;
+    tiers[2].maxDistance = 0;   tiers[2].period = 8;
+
+    LodScheduler lod;
+    lod.setTiers (tiers);
+
+    // per agent: frames not held, frames stepped, and frames not held
+    // since its last step
+    const int agents = 64, frames = 1000;
+    std::vector<int> owed (agents, 0), stepped (agents, 0), pending (agents, 0);
+    int failures = 0;
+    for (int f = 1; f <= frames; f++)
+    {
+        lod.beginFrame ();
+        lod.addPointOfInterest (Vec3::zero);
+        for (int a = 0; a < agents; a++)
+        {
+            // each agent sleeps now and then, and changes tier every few
+            // frames on a schedule of its own
+            if ((f / 37 + a) % 5 == 0)
+            {
+                lod.hold (a);
+                continue;
+            }
+            owed[a]++;
+            pending[a]++;
+            const float distance = 5.0f + 40.0f * ((f / (3 + a % 7) + a) % 3);
+            const int k = lod.stepMultiplier (a, Vec3 (distance, 0, 0));
+            if (k == 0) continue;
+            if (k != pending[a])
+            {
+                std::cerr << "agent " << a << " frame " << f << ": step of "
+                          << k << " frames, " << pending[a] << " owed"
+                          << std::endl;
+                failures++;
+            }
+            stepped[a] += k;
+            pending[a] = 0;
+        }
+    }
+
+    // whatever is not stepped yet is less than the coarsest period
+    for (int a = 0; a < agents; a++)
+        if (owed[a] - stepped[a] != pending[a] || pending[a] >= 8)
+        {
+            std::cerr << "agent " << a << ": stepped " << stepped[a]
+                      << " of " << owed[a] << " frames" << std::endl;
+            failures++;
+        }
+
+    if (failures) std::cerr << failures << " failures" << std::endl;
+    else std::cout << "LodScheduler: stepped time matches frames" << std::endl;
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,168 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// SpatialGridTest: grid queries checked against brute force
+//
+// Builds grids over several random point sets (uniform, clustered with
+// duplicates, a single point, none) at several cell sizes, and compares
+// nearest, queryRadius and queryNearest with a scan of every point, for
+// query points inside and well outside the points' bounds.
+//
+// Usage:
+//         SpatialGridTest
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#include "OpenSteer/SpatialGrid.h"
+#include "OpenSteer/Random.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+
+namespace {
+
+    using namespace OpenSteer;
+
+    int failures = 0;
+
+    void fail (const char* set, const float cellSize, const char* problem)
+    {
+        std::cerr << set << ", cell size " << cellSize << ": " << problem
+                  << std::endl;
+        failures++;
+    }
+
+    // squared distance on the XZ plane, computed as the grid does
+    float distanceSquared (const Vec3& a, const Vec3& b)
+    {
+        const float dx = a.x - b.x;
+        const float dz = a.z - b.z;
+        return dx * dx + dz * dz;
+    }
+
+    Vec3 randomPoint (RandomStream& random, const float extent)
+    {
+        return Vec3 ((random.next01 () * 2 - 1) * extent,
+                     random.next01 (),
+                     (random.next01 () * 2 - 1) * extent);
+    }
+
+    void check (const char* set,
+                const std::vector<Vec3>& points,
+                const float cellSize,
+                RandomStream& random)
+    {
+        SpatialGrid grid;
+        grid.rebuild (points.empty () ? 0 : &points[0], points.size (),
+                      cellSize);
+        if (grid.pointCount () != points.size ())
+            fail (set, cellSize, "point count");
+
+        std::vector<int> found;
+        std::vector<std::pair<float, int> > nearest;
+        for (int q = 0; q < 200; q++)
+        {
+            // some queries far outside the points' bounds
+            const Vec3 p = randomPoint (random, q % 4 ? 120.0f : 1000.0f);
+            const float radius = random.next01 () * 40;
+            const size_t k = 1 + q % 12;
+
+            // brute force: every point's distance, nearest first
+            std::vector<std::pair<float, int> > all;
+            for (size_t i = 0; i < points.size (); i++)
+                all.push_back (std::make_pair (distanceSquared (p, points[i]),
+                                               (int) i));
+            std::sort (all.begin (), all.end ());
+
+            const int n = grid.nearest (p);
+            if (points.empty () ? n != -1
+                                : (n < 0 || n >= (int) points.size () ||
+                                   distanceSquared (p, points[n]) !=
+                                   all[0].first))
+                fail (set, cellSize, "nearest");
+
+            found.clear ();
+            grid.queryRadius (p, radius, found);
+            std::sort (found.begin (), found.end ());
+            std::vector<int> within;
+            for (size_t i = 0; i < all.size (); i++)
+                if (all[i].first <= radius * radius)
+                    within.push_back (all[i].second);
+            std::sort (within.begin (), within.end ());
+            if (found != within) fail (set, cellSize, "queryRadius");
+
+            // ties may be broken either way, so compare distances
+            grid.queryNearest (p, k, radius, nearest);
+            const size_t expected = std::min (k, within.size ());
+            bool same = nearest.size () == expected;
+            for (size_t i = 0; same && i < expected; i++)
+                same = nearest[i].first == all[i].first &&
+                       distanceSquared (p, points[nearest[i].second]) ==
+                       nearest[i].first;
+            if (! same) fail (set, cellSize, "queryNearest");
+        }
+    }
+
+} // anonymous namespace
+
+
+int main (int /*argc*/, char** /*argv*/)
+{
+    RandomStream random (7, 1);
+    const float cellSizes[] = {0.5f, 4, 25, 500};
+
+    std::vector<Vec3> uniform, clustered, single, none;
+    for (int i = 0; i < 2000; i++) uniform.push_back (randomPoint (random, 100));
+    for (int i = 0; i < 500; i++)
+    {
+        // a few tight clusters, with exact duplicates
+        const Vec3 centre (40.0f * (i % 5) - 80, 0, 30.0f * (i % 3));
+        clustered.push_back (i % 7 ? centre + randomPoint (random, 0.5f)
+                                   : centre);
+    }
+    single.push_back (Vec3 (3, 0, -4));
+
+    for (size_t s = 0; s < sizeof (cellSizes) / sizeof (cellSizes[0]); s++)
+    {
+        check ("uniform", uniform, cellSizes[s], random);
+        check ("clustered", clustered, cellSizes[s], random);
+        check ("single", single, cellSizes[s], random);
+        check ("none", none, cellSizes[s], random);
+    }
+
+    if (failures) std::cerr << failures << " failures" << std::endl;
+    else std::cout << "SpatialGrid: all queries match brute force" << std::endl;
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,131 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// SpscQueueTest: full, empty and ordering behaviour of SpscQueue
+//
+// Checks capacity rounding, that pop fails on an empty queue and push on
+// a full one (and both recover), first in first out order across many
+// wraps of the ring, and a transfer of a million items between two
+// threads with none lost, duplicated or reordered.
+//
+// Usage:
+//         SpscQueueTest
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#include "OpenSteer/SpscQueue.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+
+namespace {
+
+    using namespace OpenSteer;
+
+    int failures = 0;
+
+    void expect (const bool condition, const char* what)
+    {
+        if (condition) return;
+        std::cerr << "SpscQueue: " << what << std::endl;
+        failures++;
+    }
+
+    void singleThread (void)
+    {
+        expect (SpscQueue<int> (1).capacity () == 2, "capacity of 1");
+        expect (SpscQueue<int> (5).capacity () == 8, "capacity of 5");
+        expect (SpscQueue<int> (8).capacity () == 8, "capacity of 8");
+
+        SpscQueue<int> queue (8);
+        int item = -1;
+        expect (! queue.pop (item), "pop from a new queue");
+        expect (item == -1, "failed pop changed its argument");
+
+        // fill, overflow, drain, and again, wrapping the ring many times
+        int next = 0, expected = 0;
+        for (int round = 0; round < 100; round++)
+        {
+            for (int i = 0; i < 8; i++)
+                expect (queue.push (next++), "push into a queue with room");
+            expect (! queue.push (-1), "push into a full queue");
+
+            // half out, half in: a full queue takes items again
+            for (int i = 0; i < 4; i++)
+                expect (queue.pop (item) && item == expected++, "order");
+            for (int i = 0; i < 4; i++)
+                expect (queue.push (next++), "push after pops");
+            expect (! queue.push (-1), "push into a refilled queue");
+
+            for (int i = 0; i < 8; i++)
+                expect (queue.pop (item) && item == expected++, "order");
+            expect (! queue.pop (item), "pop from a drained queue");
+        }
+    }
+
+    void twoThreads (void)
+    {
+        const int count = 1000000;
+        SpscQueue<int> queue (64);
+
+        std::thread producer ([&queue, count] ()
+        {
+            for (int i = 0; i < count; i++)
+                while (! queue.push (i)) std::this_thread::yield ();
+        });
+
+        int expected = 0, item;
+        bool ordered = true;
+        while (expected < count)
+        {
+            if (! queue.pop (item)) {std::this_thread::yield (); continue;}
+            ordered = ordered && (item == expected);
+            expected++;
+        }
+        producer.join ();
+
+        expect (ordered, "items lost, duplicated or reordered between threads");
+        expect (! queue.pop (item), "items left after the transfer");
+    }
+
+} // anonymous namespace
+
+
+int main (int /*argc*/, char** /*argv*/)
+{
+    singleThread ();
+    twoThreads ();
+    if (failures) std::cerr << failures << " failures" << std::endl;
+    else std::cout << "SpscQueue: all checks passed" << std::endl;
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
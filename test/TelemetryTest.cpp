@@ -0,0 +1,202 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// TelemetryTest: writer to reader round trip of both telemetry encodings
+//
+// Writes a few hundred frames of generated agent states to a ring file
+// small enough to wrap, reads them back and compares: raw entries must
+// match exactly, quantized ones to within their quantum.  The agents
+// move, one of them jumps beyond a 16 bit delta, and partway through one
+// agent is removed (shifting every slot) to exercise full entries and
+// keyframes.
+//
+// Usage:
+//         TelemetryTest
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#include "OpenSteer/Telemetry.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+
+namespace {
+
+    using namespace OpenSteer;
+
+    const uint32_t frames = 300;
+    const uint32_t agents = 40;
+    const uint32_t removalFrame = 280;   // agent 0 is gone from here on
+    const uint32_t jumpFrame = 290;      // agent 5 jumps from here on
+
+    int failures = 0;
+
+    void fail (const char* test, const uint32_t frame, const char* problem)
+    {
+        std::cerr << test << ": frame " << frame << ": " << problem
+                  << std::endl;
+        failures++;
+    }
+
+    // the agents present in a frame: every id, or all but the first
+    uint32_t firstId (const uint32_t frame)
+    {
+        return frame < removalFrame ? 0 : 1;
+    }
+
+    // an agent's generated state in a frame
+    Vec3 positionOf (const uint32_t id, const uint32_t frame)
+    {
+        const float angle = id * 0.7f + frame * 0.01f;
+        const float radius = 10.0f + id;
+        Vec3 p (radius * cosf (angle), 0.25f * id, radius * sinf (angle));
+        if (id == 5 && frame >= jumpFrame) p.x += 500;
+        return p;
+    }
+
+    float headingOf (const uint32_t id, const uint32_t frame)
+    {
+        return atan2f (sinf (id + frame * 0.02f), cosf (id + frame * 0.02f));
+    }
+
+    float speedOf (const uint32_t id, const uint32_t frame)
+    {
+        return id * 0.1f + (frame % 10) * 0.05f;
+    }
+
+    // smallest difference between two angles
+    float angleBetween (const float a, const float b)
+    {
+        float d = fmodf (fabsf (a - b), 2 * OPENSTEER_M_PI);
+        return d > OPENSTEER_M_PI ? 2 * OPENSTEER_M_PI - d : d;
+    }
+
+    void roundTrip (const char* test, const Telemetry::Format format)
+    {
+        const std::string path = std::string (test) + ".telemetry";
+
+        TelemetryWriter::Options options;
+        options.fileBytes = 32 << 10;
+        options.stagingBytes = 1 << 20;     // holds the whole run
+        options.format = format;
+        options.keyframeInterval = 30;
+
+        TelemetryWriter writer;
+        if (! writer.open (path, options)) {fail (test, 0, "open"); return;}
+        for (uint32_t f = 0; f < frames; f++)
+        {
+            const uint32_t first = firstId (f);
+            if (! writer.beginFrame (f, f * 0.1f, agents - first))
+                fail (test, f, "frame dropped");
+            for (uint32_t id = first; id < agents; id++)
+            {
+                const float h = headingOf (id, f);
+                writer.addAgent (id, positionOf (id, f),
+                                 Vec3 (sinf (h), 0, cosf (h)),
+                                 speedOf (id, f));
+            }
+            writer.endFrame ();
+        }
+        writer.close ();
+
+        TelemetryReader reader;
+        if (! reader.open (path)) {fail (test, 0, "reader open"); return;}
+        if (reader.format () != format) fail (test, 0, "format");
+        if (reader.framesStaged () != frames) fail (test, 0, "staged count");
+        if (reader.framesDropped () != 0) fail (test, 0, "dropped count");
+
+        // raw is exact, quantized within half a step (and float rounding)
+        const bool raw = format == Telemetry::raw;
+        const float positionTolerance =
+            raw ? 0 : 0.5f * options.positionQuantum + 1e-4f;
+        const float speedTolerance =
+            raw ? 0 : 0.5f * options.speedQuantum + 1e-4f;
+        const float headingTolerance = raw ? 1e-6f : 1e-3f;
+
+        TelemetryReader::Frame frame;
+        uint32_t read = 0, expected = 0;
+        while (reader.next (frame))
+        {
+            const uint32_t f = frame.frame;
+            if (read > 0 && f != expected) fail (test, f, "frame skipped");
+            if (read == 0 && ! raw && ! frame.keyframe)
+                fail (test, f, "does not start at a keyframe");
+            if (std::fabs (frame.time - f * 0.1f) > 1e-5f)
+                fail (test, f, "time");
+
+            const uint32_t first = firstId (f);
+            if (frame.agents.size () != agents - first)
+            {
+                fail (test, f, "agent count");
+                break;
+            }
+            for (size_t i = 0; i < frame.agents.size (); i++)
+            {
+                const Telemetry::AgentState& a = frame.agents[i];
+                const uint32_t id = first + (uint32_t) i;
+                const Vec3 d = a.position - positionOf (id, f);
+                if (a.id != id) fail (test, f, "id");
+                if (std::fabs (d.x) > positionTolerance ||
+                    std::fabs (d.y) > positionTolerance ||
+                    std::fabs (d.z) > positionTolerance)
+                    fail (test, f, "position");
+                if (angleBetween (a.heading, headingOf (id, f)) >
+                    headingTolerance)
+                    fail (test, f, "heading");
+                if (std::fabs (a.speed - speedOf (id, f)) > speedTolerance)
+                    fail (test, f, "speed");
+            }
+            expected = f + 1;
+            read++;
+        }
+
+        // the ring wrapped: it kept only the most recent frames
+        if (read == 0 || read >= frames) fail (test, 0, "ring did not wrap");
+        if (expected != frames) fail (test, frames - 1, "last frame missing");
+        std::cout << test << ": " << read << " of " << frames
+                  << " frames read back" << std::endl;
+        std::remove (path.c_str ());
+    }
+
+} // anonymous namespace
+
+
+int main (int /*argc*/, char** /*argv*/)
+{
+    roundTrip ("TelemetryRaw", Telemetry::raw);
+    roundTrip ("TelemetryQuantized", Telemetry::quantized);
+    if (failures) std::cerr << failures << " failures" << std::endl;
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,110 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//
+//
+// AnnotationBench: cost of steering annotation in the hot path
+//
+// Creates a group of vehicles scattered on a disk and times every
+// vehicle's steerToAvoidNeighbors against the whole group for a number of
+// passes, then prints the time, the size of a vehicle and whether this
+// build has annotation compiled in.  Build it with OPENSTEER_NO_ANNOTATION
+// off and on (see SteerLibrary.h) and compare; the steering results (the
+// printed checksum) are the same either way.
+//
+// Usage:
+//         AnnotationBench [vehicles] [passes]
+//         AnnotationBench 2000 5
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#include "OpenSteer/SimpleVehicle.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+
+#ifndef OPENSTEER_NO_ANNOTATION
+// normally defined by the drawing code, which this tool does not link
+bool OpenSteer::enableAnnotation = false;
+#endif
+
+
+namespace {
+
+    class BenchVehicle : public OpenSteer::SimpleVehicle
+    {
+    public:
+        void update (const float /*elapsedTime*/, OpenSteer::Vec3 /*location*/) {}
+    };
+
+} // anonymous namespace
+
+
+int main (int argc, char **argv)
+{
+    const int vehicles = argc > 1 ? std::atoi (argv[1]) : 2000;
+    const int passes = argc > 2 ? std::atoi (argv[2]) : 5;
+    if (vehicles < 1 || passes < 1)
+    {
+        std::cerr << "usage: AnnotationBench [vehicles] [passes]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    OpenSteer::RandomStream random (1, 1);
+    std::vector<BenchVehicle> group (vehicles);
+    OpenSteer::AVGroup all;
+    for (int i = 0; i < vehicles; i++)
+    {
+        const OpenSteer::Vec3 p = OpenSteer::RandomVectorInUnitRadiusSphere (random);
+        group[i].setPosition (p.setYtoZero () * 60);
+        group[i].randomizeHeadingOnXZPlane ();
+        group[i].setSpeed (1);
+        all.push_back (&group[i]);
+    }
+
+    const std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now ();
+    OpenSteer::Vec3 checksum;
+    for (int p = 0; p < passes; p++)
+        for (int i = 0; i < vehicles; i++)
+            checksum += group[i].steerToAvoidNeighbors (3, all);
+    const double ms = std::chrono::duration<double, std::milli>
+        (std::chrono::steady_clock::now () - start).count ();
+
+#ifdef OPENSTEER_NO_ANNOTATION
+    const char* build = "annotation compiled out";
+#else
+    const char* build = "annotation compiled in";
+#endif
+    std::cout << build << ": " << vehicles << " vehicles, " << passes
+              << " passes, " << ms << " ms, " << sizeof (BenchVehicle)
+              << " bytes per vehicle, checksum (" << checksum.x << ", "
+              << checksum.z << ")" << std::endl;
+    return EXIT_SUCCESS;
+}
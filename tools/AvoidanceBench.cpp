@@ -0,0 +1,161 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//
+//
+// AvoidanceBench: time pursuit steps with and without ORCA avoidance
+//
+// Builds a world of one population spread over a disk around the origin
+// (about one pursuer per 4 square units), steps it a number of frames and
+// prints milliseconds per frame, for each phase of the step, and how many
+// pursuers overlap at the end.  Runs once without avoidance and once with
+// avoid_neighbors set, on the given number of threads, so the cost of
+// avoidance at a given crowd size can be reproduced on any machine.
+//
+// Usage:
+//         AvoidanceBench [agents] [avoid_neighbors] [frames] [threads]
+//         AvoidanceBench 100000 10 20 1
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#include "OpenSteer/MultiplePursuit.h"
+#include "OpenSteer/SpatialGrid.h"
+#include "OpenSteer/TaskScheduler.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <math.h>
+
+
+namespace {
+
+    typedef std::chrono::steady_clock Clock;
+
+    double millisecondsSince (const Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>
+            (Clock::now () - start).count ();
+    }
+
+    // pairs of pursuers closer than the sum of their radii
+    size_t overlappingPairs (const OpenSteer::MpWorld& world)
+    {
+        const std::vector<OpenSteer::MpBase*>& vehicles = world.vehicles ();
+        const size_t first = world.getWandererCount ();
+        std::vector<OpenSteer::Vec3> positions;
+        for (size_t i = first; i < vehicles.size (); i++)
+            positions.push_back (vehicles[i]->position ());
+        if (positions.empty ()) return 0;
+
+        const float diameter = 2 * vehicles[first]->radius ();
+        OpenSteer::SpatialGrid grid;
+        grid.rebuild (&positions[0], positions.size (), diameter);
+        std::vector<int> found;
+        size_t pairs = 0;
+        for (size_t i = 0; i < positions.size (); i++)
+        {
+            found.clear ();
+            grid.queryRadius (positions[i], diameter * 0.99f, found);
+            pairs += found.size () - 1;
+        }
+        return pairs / 2;
+    }
+
+    void run (const int agents,
+              const int neighbors,
+              const int frames,
+              OpenSteer::TaskScheduler& scheduler)
+    {
+        OpenSteer::Scenario scenario;
+        OpenSteer::Scenario::Population& p = scenario.populations.front ();
+        p.count = agents;
+        p.spawnInner = 5;
+        p.spawnOuter = sqrtf (4 * agents / OPENSTEER_M_PI + 25);
+        scenario.avoidance.maxNeighbors = neighbors;
+
+        OpenSteer::MpWorld world;
+        world.configure (scenario);
+        world.setSeed (1);
+        world.setPublishMetrics (false);
+        world.setScheduler (&scheduler);
+        world.open ();
+
+        // the phases of update_enemies, timed one by one
+        const float dt = 0.05f;
+        double rebuild = 0, steer = 0, avoid = 0, integrate = 0;
+        for (int f = 0; f < frames; f++)
+        {
+            Clock::time_point t = Clock::now ();
+            world.beginStep (dt);
+            rebuild += millisecondsSince (t);
+            t = Clock::now ();
+            world.steer ();
+            steer += millisecondsSince (t);
+            t = Clock::now ();
+            world.avoid ();
+            avoid += millisecondsSince (t);
+            t = Clock::now ();
+            world.integrate ();
+            world.endStep ();
+            integrate += millisecondsSince (t);
+        }
+
+        const double n = frames;
+        std::cout << std::fixed << std::setprecision (2)
+                  << agents << " agents, avoid_neighbors " << neighbors
+                  << ", " << scheduler.threadCount () << " threads: "
+                  << (rebuild + steer + avoid + integrate) / n
+                  << " ms/frame (rebuild " << rebuild / n
+                  << ", steer " << steer / n
+                  << ", avoid " << avoid / n
+                  << ", integrate " << integrate / n << "), "
+                  << overlappingPairs (world) << " overlapping pairs"
+                  << std::endl;
+    }
+
+} // anonymous namespace
+
+
+int main (int argc, char **argv)
+{
+    const int agents = argc > 1 ? std::atoi (argv[1]) : 100000;
+    const int neighbors = argc > 2 ? std::atoi (argv[2]) : 10;
+    const int frames = argc > 3 ? std::atoi (argv[3]) : 20;
+    const int threads = argc > 4 ? std::atoi (argv[4]) : 1;
+    if (agents < 1 || neighbors < 1 || frames < 1 || threads < 0)
+    {
+        std::cerr << "usage: AvoidanceBench [agents] [avoid_neighbors] "
+                  << "[frames] [threads]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    OpenSteer::TaskScheduler scheduler (threads);
+    run (agents, 0, frames, scheduler);
+    run (agents, neighbors, frames, scheduler);
+    return EXIT_SUCCESS;
+}
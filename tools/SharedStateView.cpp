@@ -0,0 +1,93 @@
+// ----------------------------------------------------------------------------
+//
+//
+// OpenSteer -- Steering Behaviors for Autonomous Characters
+//
+// Copyright (c) 2002-2005, Sony Computer Entertainment America
+// Original author: Craig Reynolds <craig_reynolds@playstation.sony.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+//
+//
+//
+// SharedStateView: minimal reader of the demo's shared memory export
+//
+// Maps the segment published by "OpenSteerDemo --share <name>" and, every
+// half second, prints the latest frame's number, agent count, centroid and
+// mean speed, read in place.  A reference for viewer and analytics tools
+// and a quick check that the export works on this machine.
+//
+// Usage:
+//         OpenSteerDemo --share /opensteer &
+//         SharedStateView /opensteer 20
+//
+//
+// ----------------------------------------------------------------------------
+
+
+#include "OpenSteer/SharedState.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+
+int main (int argc, char **argv)
+{
+    const char* name = argc > 1 ? argv[1] : "/opensteer";
+    const int samples = argc > 2 ? std::atoi (argv[2]) : 10;
+
+    OpenSteer::SharedStateReader share;
+    if (! share.open (name)) return EXIT_FAILURE;
+
+    for (int s = 0; s < samples; s++)
+    {
+        // read the latest frame in place, retrying if it was overwritten
+        OpenSteer::SharedState::View v;
+        uint64_t token = 0;
+        double cx, cz, speed;
+        int retries = 0;
+        for (;; retries++)
+        {
+            // a buffer being written right now: try again
+            if (! share.beginRead (v, token)) continue;
+            cx = cz = speed = 0;
+            for (uint32_t i = 0; i < v.count; i++)
+            {
+                cx += v.x[i];
+                cz += v.z[i];
+                speed += v.speed[i];
+            }
+            if (share.endRead (token)) break;
+        }
+
+        const double n = v.count ? v.count : 1;
+        std::cout << "frame " << v.frame << " time " << v.time << ": "
+                  << v.count << " agents, centroid (" << cx / n << ", "
+                  << cz / n << "), mean speed " << speed / n
+                  << ", " << retries << " retries" << std::endl;
+        std::this_thread::sleep_for (std::chrono::milliseconds (500));
+    }
+    return EXIT_SUCCESS;
+}
+
+
+// ----------------------------------------------------------------------------